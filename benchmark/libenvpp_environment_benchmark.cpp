@@ -0,0 +1,83 @@
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <libenvpp/detail/environment.hpp>
+
+namespace env::detail {
+
+namespace {
+
+[[nodiscard]] std::vector<std::pair<std::string, std::string>> make_entries(const std::size_t num_entries)
+{
+	auto entries = std::vector<std::pair<std::string, std::string>>{};
+	entries.reserve(num_entries);
+	for (auto i = std::size_t{0}; i < num_entries; ++i) {
+		entries.emplace_back("LIBENVPP_BENCHMARK_VARIABLE_" + std::to_string(i), "value_" + std::to_string(i));
+	}
+	return entries;
+}
+
+} // namespace
+
+TEST_CASE("Environment snapshot build", "[libenvpp_benchmark]")
+{
+	const auto num_entries = GENERATE(std::size_t{100}, std::size_t{1'000}, std::size_t{10'000}, std::size_t{100'000});
+	const auto entries = make_entries(num_entries);
+
+	BENCHMARK("std::unordered_map " + std::to_string(num_entries))
+	{
+		auto map = std::unordered_map<std::string, std::string>{};
+		for (const auto& [name, value] : entries) {
+			map.try_emplace(name, value);
+		}
+		return map;
+	};
+
+	BENCHMARK("environment_snapshot " + std::to_string(num_entries))
+	{
+		return environment_snapshot(entries);
+	};
+}
+
+TEST_CASE("Environment snapshot lookup", "[libenvpp_benchmark]")
+{
+	const auto num_entries = GENERATE(std::size_t{100}, std::size_t{1'000}, std::size_t{10'000}, std::size_t{100'000});
+	const auto entries = make_entries(num_entries);
+	const auto map = std::unordered_map<std::string, std::string>(entries.begin(), entries.end());
+	const auto snapshot = environment_snapshot(entries);
+
+	// Lookups are done by 'std::string_view', as they are when parsing, half of them are misses.
+	auto names = std::vector<std::string>{};
+	for (auto i = std::size_t{0}; i < num_entries; ++i) {
+		names.push_back(entries[i].first + (i % 2 == 0 ? "" : "_MISSING"));
+	}
+	const auto name_views = std::vector<std::string_view>(names.begin(), names.end());
+
+	BENCHMARK("std::unordered_map " + std::to_string(num_entries))
+	{
+		auto num_found = std::size_t{0};
+		for (const auto name : name_views) {
+			num_found += map.find(std::string(name)) != map.end();
+		}
+		return num_found;
+	};
+
+	BENCHMARK("environment_snapshot " + std::to_string(num_entries))
+	{
+		auto num_found = std::size_t{0};
+		for (const auto name : name_views) {
+			num_found += snapshot.find(name).has_value();
+		}
+		return num_found;
+	};
+}
+
+} // namespace env::detail
@@ -0,0 +1,86 @@
+#include <cstdint>
+#include <istream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <libenvpp/detail/parser.hpp>
+
+namespace env::detail {
+
+namespace {
+
+struct stream_id {
+	std::uint64_t value;
+};
+
+std::istream& operator>>(std::istream& stream, stream_id& id)
+{
+	return stream >> id.value;
+}
+
+// Parsing as it was done before streams were reused, constructing a new stream for every value.
+[[nodiscard]] stream_id construct_with_new_stream(const std::string_view str)
+{
+	auto stream = std::istringstream(std::string(str));
+	auto id = stream_id{};
+	stream >> id;
+	if (!stream.eof()) {
+		stream >> std::ws;
+	}
+	if (stream.fail() || static_cast<std::size_t>(stream.tellg()) < str.size()) {
+		throw parser_error{"Failed to parse"};
+	}
+	return id;
+}
+
+} // namespace
+
+TEST_CASE("Stream parsing of custom types", "[libenvpp_benchmark]")
+{
+	constexpr auto input = std::string_view("1234567890123");
+
+	BENCHMARK("new stream per value")
+	{
+		return construct_with_new_stream(input);
+	};
+
+	BENCHMARK("reused stream")
+	{
+		return construct_from_string<stream_id>(input);
+	};
+}
+
+TEST_CASE("Parsing of arithmetic types", "[libenvpp_benchmark]")
+{
+	BENCHMARK("std::istringstream int")
+	{
+		auto stream = std::istringstream(std::string("123456789"));
+		auto value = 0;
+		stream >> value;
+		return value;
+	};
+
+	BENCHMARK("construct_from_string int")
+	{
+		return construct_from_string<int>("123456789");
+	};
+
+	BENCHMARK("std::istringstream double")
+	{
+		auto stream = std::istringstream(std::string("3.1415926535"));
+		auto value = 0.0;
+		stream >> value;
+		return value;
+	};
+
+	BENCHMARK("construct_from_string double")
+	{
+		return construct_from_string<double>("3.1415926535");
+	};
+}
+
+} // namespace env::detail
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+
+#include <fmt/format.h>
+
+namespace env {
+
+// Number of bytes, which is parsed from a number with an optional unit suffix, e.g. '512MiB'.
+class byte_size {
+  public:
+	constexpr byte_size() noexcept = default;
+	constexpr explicit byte_size(const std::uint64_t count) noexcept : m_count(count) {}
+
+	[[nodiscard]] constexpr std::uint64_t count() const noexcept { return m_count; }
+
+	[[nodiscard]] friend constexpr bool operator==(const byte_size lhs, const byte_size rhs) noexcept
+	{
+		return lhs.m_count == rhs.m_count;
+	}
+	[[nodiscard]] friend constexpr bool operator!=(const byte_size lhs, const byte_size rhs) noexcept
+	{
+		return !(lhs == rhs);
+	}
+	[[nodiscard]] friend constexpr bool operator<(const byte_size lhs, const byte_size rhs) noexcept
+	{
+		return lhs.m_count < rhs.m_count;
+	}
+	[[nodiscard]] friend constexpr bool operator>(const byte_size lhs, const byte_size rhs) noexcept
+	{
+		return rhs < lhs;
+	}
+	[[nodiscard]] friend constexpr bool operator<=(const byte_size lhs, const byte_size rhs) noexcept
+	{
+		return !(rhs < lhs);
+	}
+	[[nodiscard]] friend constexpr bool operator>=(const byte_size lhs, const byte_size rhs) noexcept
+	{
+		return !(lhs < rhs);
+	}
+
+  private:
+	std::uint64_t m_count = 0;
+};
+
+inline constexpr auto kibibytes(const std::uint64_t count) noexcept
+{
+	return byte_size(count * 1024);
+}
+
+inline constexpr auto mebibytes(const std::uint64_t count) noexcept
+{
+	return byte_size(count * 1024 * 1024);
+}
+
+inline constexpr auto gibibytes(const std::uint64_t count) noexcept
+{
+	return byte_size(count * 1024 * 1024 * 1024);
+}
+
+} // namespace env
+
+template <>
+struct fmt::formatter<env::byte_size> : fmt::formatter<std::uint64_t> {
+	template <typename FormatContext>
+	auto format(const env::byte_size size, FormatContext& ctx) const -> decltype(ctx.out())
+	{
+		auto out = fmt::formatter<std::uint64_t>::format(size.count(), ctx);
+		return fmt::format_to(out, "B");
+	}
+};
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <libenvpp/detail/errors.hpp>
+
+namespace env {
+
+// Binary data, which is parsed from its base64 (default), base64url, or hex encoding.
+using bytes = std::vector<std::byte>;
+
+enum class bytes_encoding {
+	base64,
+	base64url,
+	hex,
+};
+
+namespace detail {
+
+inline constexpr auto invalid_digit = std::uint8_t{0xFF};
+
+using decoding_table = std::array<std::uint8_t, 256>;
+
+[[nodiscard]] constexpr decoding_table make_decoding_table(const std::string_view alphabet, const bool ignore_case)
+{
+	auto table = decoding_table{};
+	for (auto& digit : table) {
+		digit = invalid_digit;
+	}
+	for (std::size_t i = 0; i < alphabet.size(); ++i) {
+		const auto c = static_cast<unsigned char>(alphabet[i]);
+		table[c] = static_cast<std::uint8_t>(i);
+		if (ignore_case && 'a' <= c && c <= 'z') {
+			table[c - 'a' + 'A'] = static_cast<std::uint8_t>(i);
+		}
+	}
+	return table;
+}
+
+inline constexpr auto base64_table =
+    make_decoding_table("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/", false);
+inline constexpr auto base64url_table =
+    make_decoding_table("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_", false);
+inline constexpr auto hex_table = make_decoding_table("0123456789abcdef", true);
+
+[[nodiscard]] constexpr std::string_view get_encoding_name(const bytes_encoding encoding) noexcept
+{
+	switch (encoding) {
+	case bytes_encoding::base64:
+		return "base64";
+	case bytes_encoding::base64url:
+		return "base64url";
+	case bytes_encoding::hex:
+		return "hex";
+	}
+	return "";
+}
+
+// Only called once decoding failed, to find the first invalid character for the error message.
+[[noreturn]] inline void throw_invalid_digit(const std::string_view str, const decoding_table& table,
+                                             const bytes_encoding encoding)
+{
+	for (std::size_t i = 0; i < str.size(); ++i) {
+		if (table[static_cast<unsigned char>(str[i])] == invalid_digit) {
+			throw parser_error{fmt::format("Invalid {} character '{}' at position {}", get_encoding_name(encoding),
+			                               str[i], i)};
+		}
+	}
+	throw parser_error{fmt::format("Invalid {} input '{}'", get_encoding_name(encoding), str)};
+}
+
+// Decodes 'str' into 'out', which must have room for exactly 'str.size() / 2' bytes. Returns false if 'str' contains
+// invalid characters. Instead of checking every character, the decoded digits are combined, and checked once per
+// block, as invalid digits have their high bit set.
+[[nodiscard]] inline bool decode_hex(const std::string_view str, std::byte* out) noexcept
+{
+	constexpr auto block_size = std::size_t{16};
+	const auto* in = reinterpret_cast<const unsigned char*>(str.data());
+	const auto size = str.size() / 2;
+	auto invalid = std::uint8_t{0};
+	auto i = std::size_t{0};
+	for (; i + block_size <= size; i += block_size) {
+		for (std::size_t j = 0; j < block_size; ++j) {
+			const auto high = hex_table[in[2 * (i + j)]];
+			const auto low = hex_table[in[2 * (i + j) + 1]];
+			invalid |= high | low;
+			out[i + j] = static_cast<std::byte>((high << 4) | (low & 0x0F));
+		}
+		if ((invalid & 0x80) != 0) {
+			return false;
+		}
+	}
+	for (; i < size; ++i) {
+		const auto high = hex_table[in[2 * i]];
+		const auto low = hex_table[in[2 * i + 1]];
+		invalid |= high | low;
+		out[i] = static_cast<std::byte>((high << 4) | (low & 0x0F));
+	}
+	return (invalid & 0x80) == 0;
+}
+
+// Decodes 'str', which must not contain padding, into 'out', which must have room for exactly the decoded bytes.
+// Returns false if 'str' contains invalid characters, which are checked once per block of groups of four characters.
+[[nodiscard]] inline bool decode_base64(const std::string_view str, const decoding_table& table,
+                                        std::byte* out) noexcept
+{
+	constexpr auto block_size = std::size_t{8};
+	const auto* in = reinterpret_cast<const unsigned char*>(str.data());
+	const auto groups = str.size() / 4;
+	auto invalid = std::uint8_t{0};
+	const auto decode_group = [&](const unsigned char* group, std::byte* bytes_out) {
+		const auto a = table[group[0]];
+		const auto b = table[group[1]];
+		const auto c = table[group[2]];
+		const auto d = table[group[3]];
+		invalid |= a | b | c | d;
+		const auto bits = (std::uint32_t{a} << 18) | (std::uint32_t{b} << 12) | (std::uint32_t{c} << 6) | d;
+		bytes_out[0] = static_cast<std::byte>(bits >> 16);
+		bytes_out[1] = static_cast<std::byte>(bits >> 8);
+		bytes_out[2] = static_cast<std::byte>(bits);
+	};
+
+	auto i = std::size_t{0};
+	for (; i + block_size <= groups; i += block_size) {
+		for (std::size_t j = 0; j < block_size; ++j) {
+			decode_group(in + 4 * (i + j), out + 3 * (i + j));
+		}
+		if ((invalid & 0x80) != 0) {
+			return false;
+		}
+	}
+	for (; i < groups; ++i) {
+		decode_group(in + 4 * i, out + 3 * i);
+	}
+
+	// The last group of two or three characters encodes one or two bytes.
+	const auto remaining = str.size() % 4;
+	if (remaining != 0) {
+		unsigned char group[4] = {'A', 'A', 'A', 'A'};
+		for (std::size_t j = 0; j < remaining; ++j) {
+			group[j] = in[4 * groups + j];
+		}
+		std::byte bytes_out[3] = {};
+		decode_group(group, bytes_out);
+		for (std::size_t j = 0; j + 1 < remaining; ++j) {
+			out[3 * groups + j] = bytes_out[j];
+		}
+	}
+	return (invalid & 0x80) == 0;
+}
+
+// Decodes 'str' in the given encoding. The output is sized exactly before decoding, and the input is validated while
+// decoding. Padding is optional for base64 and base64url.
+[[nodiscard]] inline bytes decode_bytes(const std::string_view str, const bytes_encoding encoding)
+{
+	auto value = bytes{};
+	if (encoding == bytes_encoding::hex) {
+		if (str.size() % 2 != 0) {
+			throw parser_error{fmt::format("Invalid hex input '{}', the number of digits must be even", str)};
+		}
+		value.resize(str.size() / 2);
+		if (!decode_hex(str, value.data())) {
+			throw_invalid_digit(str, hex_table, encoding);
+		}
+		return value;
+	}
+
+	const auto& table = encoding == bytes_encoding::base64 ? base64_table : base64url_table;
+	auto input = str;
+	for (auto i = 0; i < 2 && !input.empty() && input.back() == '='; ++i) {
+		input.remove_suffix(1);
+	}
+	if ((input.size() != str.size() && str.size() % 4 != 0) || input.size() % 4 == 1) {
+		throw parser_error{
+		    fmt::format("Invalid {} input '{}', the length is invalid", get_encoding_name(encoding), str)};
+	}
+	value.resize(input.size() / 4 * 3 + (input.size() % 4 == 0 ? 0 : input.size() % 4 - 1));
+	if (!decode_base64(input, table, value.data())) {
+		throw_invalid_digit(input, table, encoding);
+	}
+	// The bits of the last character which do not belong to a byte must be zero, so that every value has exactly one
+	// encoding.
+	const auto unused_bits_mask = input.size() % 4 == 2 ? 0x0F : input.size() % 4 == 3 ? 0x03 : 0x00;
+	if (unused_bits_mask != 0 && (table[static_cast<unsigned char>(input.back())] & unused_bits_mask) != 0) {
+		throw parser_error{
+		    fmt::format("Invalid {} input '{}', the unused bits are not zero", get_encoding_name(encoding), str)};
+	}
+	return value;
+}
+
+} // namespace detail
+
+} // namespace env
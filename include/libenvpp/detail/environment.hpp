@@ -1,9 +1,22 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <libenvpp/detail/environment_source.hpp>
+#include <libenvpp/detail/levenshtein.hpp>
+#include <libenvpp/detail/name_pool.hpp>
 
 namespace env::detail {
 
@@ -14,6 +27,326 @@ std::optional<std::wstring> convert_string(const std::string& str);
 
 #endif
 
+struct environment_entry {
+	std::string_view name;
+	std::string_view value;
+};
+
+// Splits a single "NAME=VALUE" entry of the environment at the first '='. Entries without '=' are treated as having an
+// empty value.
+[[nodiscard]] inline environment_entry split_environment_entry(const char* const var)
+{
+	const auto var_length = std::strlen(var);
+	const auto delimiter = static_cast<const char*>(std::memchr(var, '=', var_length));
+	if (delimiter == nullptr) {
+		return {std::string_view(var, var_length), std::string_view()};
+	}
+	const auto name_length = static_cast<std::size_t>(delimiter - var);
+	return {std::string_view(var, name_length), std::string_view(delimiter + 1, var_length - name_length - 1)};
+}
+
+// Non-owning view of the process environment, which does not copy any names or values. Entries are split into name and
+// value lazily while iterating. The view is invalidated by any modification of the process environment.
+class environment_view {
+  public:
+	class iterator {
+	  public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = environment_entry;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = environment_entry;
+
+		iterator() = default;
+		explicit iterator(const char* const* var) : m_var(var) {}
+
+		[[nodiscard]] environment_entry operator*() const { return split_environment_entry(*m_var); }
+
+		iterator& operator++()
+		{
+			++m_var;
+			return *this;
+		}
+
+		iterator operator++(int)
+		{
+			auto it = *this;
+			++m_var;
+			return it;
+		}
+
+		[[nodiscard]] bool operator==(const iterator& other) const noexcept { return m_var == other.m_var; }
+		[[nodiscard]] bool operator!=(const iterator& other) const noexcept { return !(*this == other); }
+
+	  private:
+		const char* const* m_var = nullptr;
+	};
+
+	environment_view() = default;
+
+	// Views the null-terminated array of "NAME=VALUE" strings 'vars', which must outlive the view.
+	explicit environment_view(const char* const* vars) : m_begin(vars), m_end(vars)
+	{
+		if (m_end != nullptr) {
+			while (*m_end != nullptr) {
+				++m_end;
+			}
+		}
+	}
+
+	environment_view(const environment_view&) = delete;
+	environment_view(environment_view&&) = default;
+
+	environment_view& operator=(const environment_view&) = delete;
+	environment_view& operator=(environment_view&&) = default;
+
+	[[nodiscard]] iterator begin() const noexcept { return iterator(m_begin); }
+	[[nodiscard]] iterator end() const noexcept { return iterator(m_end); }
+
+	[[nodiscard]] std::size_t size() const noexcept { return static_cast<std::size_t>(m_end - m_begin); }
+	[[nodiscard]] bool empty() const noexcept { return m_begin == m_end; }
+
+	// Returns the value of the first entry named 'name', matching the behavior of getenv.
+	[[nodiscard]] std::optional<std::string_view> find(const std::string_view name) const
+	{
+		for (auto var = m_begin; var != m_end; ++var) {
+			const auto* entry = *var;
+			if (std::strncmp(entry, name.data(), name.size()) == 0
+			    && (entry[name.size()] == '=' || entry[name.size()] == '\0')) {
+				const auto* value = entry + name.size();
+				return *value == '\0' ? std::string_view() : std::string_view(value + 1);
+			}
+		}
+		return std::nullopt;
+	}
+
+  private:
+	// Takes ownership of the entries, used on platforms where the environment has to be converted first.
+	environment_view(std::unique_ptr<char[]> storage, std::vector<const char*> vars)
+	    : m_storage(std::move(storage)), m_owned_vars(std::move(vars))
+	{
+		m_owned_vars.push_back(nullptr);
+		m_begin = m_owned_vars.data();
+		m_end = m_begin + m_owned_vars.size() - 1;
+	}
+
+	std::unique_ptr<char[]> m_storage;
+	std::vector<const char*> m_owned_vars;
+	const char* const* m_begin = nullptr;
+	const char* const* m_end = nullptr;
+
+	friend environment_view get_environment_view();
+};
+
+[[nodiscard]] environment_view get_environment_view();
+
+// Owning snapshot of (a subset of) the environment. Names and values of all entries are stored contiguously in a single
+// arena, and are indexed by an open-addressing hash table with linear probing, so a snapshot only needs a constant
+// number of allocations independent of the number of entries. Lookups by 'std::string_view' do not allocate.
+// Consuming an entry marks it with a tombstone, which hides it from lookups and iteration without erasing it.
+class environment_snapshot {
+	struct entry {
+		std::size_t hash;
+		std::size_t offset;
+		std::uint32_t name_length;
+		std::uint32_t value_length;
+		bool consumed;
+	};
+
+	static constexpr auto empty_slot = std::uint32_t{0};
+
+  public:
+	class iterator {
+	  public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = environment_entry;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = environment_entry;
+
+		iterator() = default;
+		iterator(const char* storage, const entry* current, const entry* end)
+		    : m_storage(storage), m_entry(current), m_end(end)
+		{
+			skip_consumed();
+		}
+
+		[[nodiscard]] environment_entry operator*() const { return get_entry(m_storage, *m_entry); }
+
+		iterator& operator++()
+		{
+			++m_entry;
+			skip_consumed();
+			return *this;
+		}
+
+		iterator operator++(int)
+		{
+			auto it = *this;
+			++*this;
+			return it;
+		}
+
+		[[nodiscard]] bool operator==(const iterator& other) const noexcept { return m_entry == other.m_entry; }
+		[[nodiscard]] bool operator!=(const iterator& other) const noexcept { return !(*this == other); }
+
+	  private:
+		void skip_consumed() noexcept
+		{
+			while (m_entry != m_end && m_entry->consumed) {
+				++m_entry;
+			}
+		}
+
+		const char* m_storage = nullptr;
+		const entry* m_entry = nullptr;
+		const entry* m_end = nullptr;
+	};
+
+	environment_snapshot() = default;
+
+	// Copies all entries of 'environment'.
+	template <typename Environment>
+	explicit environment_snapshot(const Environment& environment)
+	    : environment_snapshot(environment, [](const std::string_view) { return true; })
+	{
+	}
+
+	// Copies those entries of 'environment', which can be any type supported by 'environment_source', for which
+	// 'is_relevant(name)' returns true. The entries are collected first, so that the arena and the table can be
+	// allocated with their final size. If a name occurs multiple times, the first entry is used.
+	template <typename Environment, typename Predicate>
+	environment_snapshot(const Environment& environment, Predicate&& is_relevant)
+	{
+		auto relevant_entries = std::vector<environment_entry>{};
+		auto storage_size = std::size_t{0};
+		environment_source<Environment>{}.for_each(
+		    environment, [&](const std::string_view name, const std::string_view value) {
+			    if (is_relevant(name)) {
+				    relevant_entries.push_back({name, value});
+				    storage_size += name.size() + value.size();
+			    }
+		    });
+
+		m_storage.reserve(storage_size);
+		m_entries.reserve(relevant_entries.size());
+		m_slots.resize(get_num_slots(relevant_entries.size()), empty_slot);
+		for (const auto& [name, value] : relevant_entries) {
+			insert(name, value);
+		}
+	}
+
+	[[nodiscard]] iterator begin() const noexcept
+	{
+		return iterator(m_storage.data(), m_entries.data(), m_entries.data() + m_entries.size());
+	}
+	[[nodiscard]] iterator end() const noexcept
+	{
+		const auto* end = m_entries.data() + m_entries.size();
+		return iterator(m_storage.data(), end, end);
+	}
+
+	// Number of entries which have not been consumed.
+	[[nodiscard]] std::size_t size() const noexcept { return m_entries.size() - m_num_consumed; }
+	[[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+	[[nodiscard]] std::optional<std::string_view> find(const std::string_view name) const
+	{
+		return find(name, hash_env_var_name(name));
+	}
+
+	// Same as 'find', but using the precomputed 'hash' of 'name'.
+	[[nodiscard]] std::optional<std::string_view> find(const std::string_view name, const std::size_t hash) const
+	{
+		const auto idx = find_entry(name, hash);
+		if (idx == m_entries.size() || m_entries[idx].consumed) {
+			return std::nullopt;
+		}
+		return get_entry(m_storage.data(), m_entries[idx]).value;
+	}
+
+	// Marks the entry 'name' as consumed, returns whether an unconsumed entry was found.
+	bool consume(const std::string_view name) { return consume(name, hash_env_var_name(name)); }
+
+	// Same as 'consume', but using the precomputed 'hash' of 'name'.
+	bool consume(const std::string_view name, const std::size_t hash)
+	{
+		const auto idx = find_entry(name, hash);
+		if (idx == m_entries.size() || m_entries[idx].consumed) {
+			return false;
+		}
+		m_entries[idx].consumed = true;
+		++m_num_consumed;
+		return true;
+	}
+
+  private:
+	[[nodiscard]] static environment_entry get_entry(const char* storage, const entry& e) noexcept
+	{
+		const auto* name = storage + e.offset;
+		return {std::string_view(name, e.name_length), std::string_view(name + e.name_length, e.value_length)};
+	}
+
+	[[nodiscard]] static std::size_t get_num_slots(const std::size_t num_entries) noexcept
+	{
+		// Power of two with a load factor of at most 0.5, keeping probe sequences short.
+		auto num_slots = std::size_t{8};
+		while (num_slots < 2 * num_entries) {
+			num_slots *= 2;
+		}
+		return num_slots;
+	}
+
+	// Returns the index of the entry named 'name', or the number of entries if there is none.
+	[[nodiscard]] std::size_t find_entry(const std::string_view name, const std::size_t hash) const noexcept
+	{
+		if (m_entries.empty()) {
+			return m_entries.size();
+		}
+		const auto mask = m_slots.size() - 1;
+		for (auto slot = hash & mask; m_slots[slot] != empty_slot; slot = (slot + 1) & mask) {
+			const auto& e = m_entries[m_slots[slot] - 1];
+			if (e.hash == hash && get_entry(m_storage.data(), e).name == name) {
+				return m_slots[slot] - 1;
+			}
+		}
+		return m_entries.size();
+	}
+
+	void insert(const std::string_view name, const std::string_view value)
+	{
+		const auto hash = hash_env_var_name(name);
+		const auto mask = m_slots.size() - 1;
+		auto slot = hash & mask;
+		for (; m_slots[slot] != empty_slot; slot = (slot + 1) & mask) {
+			const auto& e = m_entries[m_slots[slot] - 1];
+			if (e.hash == hash && get_entry(m_storage.data(), e).name == name) {
+				return;
+			}
+		}
+		m_entries.push_back({hash, m_storage.size(), static_cast<std::uint32_t>(name.size()),
+		                     static_cast<std::uint32_t>(value.size()), false});
+		m_slots[slot] = static_cast<std::uint32_t>(m_entries.size());
+		m_storage.append(name);
+		m_storage.append(value);
+	}
+
+	std::string m_storage;
+	std::vector<entry> m_entries;
+	std::vector<std::uint32_t> m_slots;
+	std::size_t m_num_consumed = 0;
+};
+
+// Returns the process-wide snapshot of the environment, which is built on first use and shared read-only afterwards.
+// It is rebuilt on the next call after the environment was changed through the library, or after 'refresh_snapshot'.
+[[nodiscard]] std::shared_ptr<const environment_snapshot> get_environment_snapshot();
+
+// Returns the process-wide snapshot if it is up to date, or nullptr without building it otherwise.
+[[nodiscard]] std::shared_ptr<const environment_snapshot> get_current_environment_snapshot();
+
+// Bumps the generation of the environment, outdating the process-wide snapshot.
+void invalidate_environment_snapshot() noexcept;
+
 [[nodiscard]] std::unordered_map<std::string, std::string> get_environment();
 
 [[nodiscard]] std::optional<std::string> get_environment_variable(const std::string_view name);
@@ -51,11 +384,322 @@ class set_scoped_environment_variable {
 	std::optional<std::string> m_old_value;
 };
 
+template <typename Environment, typename = void>
+struct is_consumable_environment : std::false_type {
+};
+
+template <typename Environment>
+struct is_consumable_environment<
+    Environment, std::void_t<decltype(std::declval<Environment&>().consume(std::declval<std::string_view>()))>>
+    : std::true_type {
+};
+
+template <typename Environment>
+inline constexpr auto is_consumable_environment_v = is_consumable_environment<Environment>::value;
+
+// Environments supporting lookups with a precomputed hash of the name (like 'environment_snapshot'), which must also be
+// supported for consuming variables if the environment is consumable.
+template <typename Environment, typename = void>
+struct is_hashed_environment : std::false_type {
+};
+
+template <typename Environment>
+struct is_hashed_environment<Environment,
+                             std::void_t<decltype(std::declval<const Environment&>().find(
+                                 std::declval<std::string_view>(), std::declval<std::size_t>()))>> : std::true_type {
+};
+
+template <typename Environment>
+inline constexpr auto is_hashed_environment_v = is_hashed_environment<Environment>::value;
+
+// Set of variable names, which are copied into a single arena and indexed by an open-addressing hash table with linear
+// probing, so that lookups by 'std::string_view' with a precomputed hash do not allocate.
+class name_set {
+	struct entry {
+		std::size_t hash;
+		std::size_t offset;
+		std::size_t length;
+	};
+
+	static constexpr auto empty_slot = std::uint32_t{0};
+
+  public:
+	[[nodiscard]] bool empty() const noexcept { return m_entries.empty(); }
+
+	[[nodiscard]] bool contains(const std::string_view name, const std::size_t hash) const noexcept
+	{
+		return !m_entries.empty() && m_slots[find_slot(name, hash)] != empty_slot;
+	}
+
+	void insert(const std::string_view name, const std::size_t hash)
+	{
+		// Keeps the load factor at most 0.5, keeping probe sequences short.
+		if (2 * (m_entries.size() + 1) > m_slots.size()) {
+			rehash(m_slots.empty() ? std::size_t{16} : 2 * m_slots.size());
+		}
+		const auto slot = find_slot(name, hash);
+		if (m_slots[slot] != empty_slot) {
+			return;
+		}
+		m_entries.push_back({hash, m_storage.size(), name.size()});
+		m_storage.append(name);
+		m_slots[slot] = static_cast<std::uint32_t>(m_entries.size());
+	}
+
+  private:
+	// Returns the slot of the entry named 'name', or the empty slot where it would be inserted.
+	[[nodiscard]] std::size_t find_slot(const std::string_view name, const std::size_t hash) const noexcept
+	{
+		const auto mask = m_slots.size() - 1;
+		auto slot = hash & mask;
+		for (; m_slots[slot] != empty_slot; slot = (slot + 1) & mask) {
+			const auto& e = m_entries[m_slots[slot] - 1];
+			if (e.hash == hash && std::string_view(m_storage).substr(e.offset, e.length) == name) {
+				break;
+			}
+		}
+		return slot;
+	}
+
+	void rehash(const std::size_t num_slots)
+	{
+		m_slots.assign(num_slots, empty_slot);
+		const auto mask = num_slots - 1;
+		for (std::size_t i = 0; i < m_entries.size(); ++i) {
+			auto slot = m_entries[i].hash & mask;
+			while (m_slots[slot] != empty_slot) {
+				slot = (slot + 1) & mask;
+			}
+			m_slots[slot] = static_cast<std::uint32_t>(i + 1);
+		}
+	}
+
+	std::string m_storage;
+	std::vector<entry> m_entries;
+	std::vector<std::uint32_t> m_slots;
+};
+
+// Environment consisting of a high precedence environment layered on top of a low precedence one, which is consumed
+// while parsing. Neither of the underlying environments is copied or modified, consumed variables are hidden instead.
+// The low precedence environment can be any type supported by 'environment_source'. If it is passed as non-const and
+// supports consuming variables itself (like 'environment_snapshot'), variables are marked as consumed in place.
+// Otherwise they are tracked in a hashed set, so that checking whether a variable was consumed does not allocate.
+template <typename Environment>
+class layered_environment {
+	using high_precedence_environment_t = std::unordered_map<std::string, std::string>;
+
+  public:
+	layered_environment(const high_precedence_environment_t& high_precedence_env, const Environment& low_precedence_env)
+	    : m_high_precedence_env(high_precedence_env), m_low_precedence_env(low_precedence_env)
+	{
+		index_high_precedence_env();
+	}
+
+	layered_environment(const high_precedence_environment_t& high_precedence_env, Environment& low_precedence_env)
+	    : m_high_precedence_env(high_precedence_env), m_low_precedence_env(low_precedence_env)
+	{
+		index_high_precedence_env();
+		if constexpr (is_consumable_environment_v<Environment>) {
+			m_consumable_low_precedence_env = &low_precedence_env;
+		}
+	}
+
+	layered_environment(const layered_environment&) = delete;
+	layered_environment& operator=(const layered_environment&) = delete;
+
+	[[nodiscard]] std::optional<std::string_view> find(const std::string_view name) const
+	{
+		return find(name, hash_env_var_name(name));
+	}
+
+	// Same as 'find', but using the precomputed 'hash' of 'name'.
+	[[nodiscard]] std::optional<std::string_view> find(const std::string_view name, const std::size_t hash) const
+	{
+		if (m_consumed.contains(name, hash)) {
+			return std::nullopt;
+		}
+		if (const auto it = m_high_precedence_index.find(name); it != m_high_precedence_index.end()) {
+			return it->second;
+		}
+		if constexpr (is_hashed_environment_v<Environment>) {
+			return m_low_precedence_env.find(name, hash);
+		} else {
+			return environment_source<Environment>{}.find(m_low_precedence_env, name);
+		}
+	}
+
+	void consume(const std::string_view name) { consume(name, hash_env_var_name(name)); }
+
+	// Same as 'consume', but using the precomputed 'hash' of 'name'.
+	void consume(const std::string_view name, const std::size_t hash)
+	{
+		if (m_consumable_low_precedence_env != nullptr && !is_in_high_precedence_env(name)) {
+			if constexpr (is_consumable_environment_v<Environment>) {
+				const auto consumed = [&] {
+					if constexpr (is_hashed_environment_v<Environment>) {
+						return m_consumable_low_precedence_env->consume(name, hash);
+					} else {
+						return m_consumable_low_precedence_env->consume(name);
+					}
+				}();
+				if (consumed) {
+					return;
+				}
+			}
+		}
+		m_consumed.insert(name, hash);
+	}
+
+	// Invokes 'fn(name, value)' for every variable which has not been consumed yet.
+	template <typename Fn>
+	void for_each(Fn&& fn) const
+	{
+		for (const auto& [name, value] : m_high_precedence_env) {
+			if (!is_consumed(name)) {
+				fn(std::string_view(name), std::string_view(value));
+			}
+		}
+		environment_source<Environment>{}.for_each(
+		    m_low_precedence_env, [&](const std::string_view name, const std::string_view value) {
+			    if (!is_consumed(name) && !is_in_high_precedence_env(name)) {
+				    fn(name, value);
+			    }
+		    });
+	}
+
+  private:
+	void index_high_precedence_env()
+	{
+		m_high_precedence_index.reserve(m_high_precedence_env.size());
+		for (const auto& [name, value] : m_high_precedence_env) {
+			m_high_precedence_index.emplace(name, value);
+		}
+	}
+
+	[[nodiscard]] bool is_in_high_precedence_env(const std::string_view name) const
+	{
+		return !m_high_precedence_index.empty() && m_high_precedence_index.count(name) != 0;
+	}
+
+	[[nodiscard]] bool is_consumed(const std::string_view name) const
+	{
+		return !m_consumed.empty() && m_consumed.contains(name, hash_env_var_name(name));
+	}
+
+	const high_precedence_environment_t& m_high_precedence_env;
+	// Views of the names and values of the high precedence environment, which can be looked up without allocating.
+	std::unordered_map<std::string_view, std::string_view> m_high_precedence_index;
+	const Environment& m_low_precedence_env;
+	Environment* m_consumable_low_precedence_env = nullptr;
+	name_set m_consumed;
+};
+
+// Computes the edit distance between 'lhs' and 'rhs', up to a maximum of 'cutoff_distance'. The edit distance is at
+// least the difference in length, which is checked first as it is much cheaper to compute.
+[[nodiscard]] inline int bounded_edit_distance(const std::string_view lhs, const std::string_view rhs,
+                                               const int cutoff_distance)
+{
+	const auto length_difference =
+	    lhs.length() > rhs.length() ? lhs.length() - rhs.length() : rhs.length() - lhs.length();
+	if (length_difference >= static_cast<std::size_t>(cutoff_distance)) {
+		return cutoff_distance;
+	}
+	return levenshtein::distance(lhs, rhs, cutoff_distance);
+}
+
+// Updates 'similar_var' if 'environment' contains a variable which is more similar to 'var_name' than
+// 'similar_var_edit_dist'.
+template <typename Environment>
+void update_similar_env_var(const std::string_view var_name, const layered_environment<Environment>& environment,
+                            std::optional<std::string>& similar_var, int& similar_var_edit_dist)
+{
+	environment.for_each([&](const std::string_view name, const std::string_view) {
+		const auto edit_dist = bounded_edit_distance(var_name, name, similar_var_edit_dist);
+		if (edit_dist < similar_var_edit_dist) {
+			similar_var = std::string(name);
+			similar_var_edit_dist = edit_dist;
+		}
+	});
+}
+
+template <typename Environment>
+[[nodiscard]] std::optional<std::string> find_similar_env_var(const std::string_view var_name,
+                                                              const layered_environment<Environment>& environment,
+                                                              const int edit_distance_cutoff)
+{
+	auto similar_var = std::optional<std::string>{};
+	auto similar_var_edit_dist = edit_distance_cutoff + 1;
+	update_similar_env_var(var_name, environment, similar_var, similar_var_edit_dist);
+	return similar_var;
+}
+
+// Same as 'find_similar_env_var', but looks in two environments, preferring 'environment' for equally similar
+// variables.
+template <typename Environment, typename OtherEnvironment>
 [[nodiscard]] std::optional<std::string>
-find_similar_env_var(const std::string_view var_name, const std::unordered_map<std::string, std::string>& environment,
-                     const int edit_distance_cutoff);
+find_similar_env_var(const std::string_view var_name, const layered_environment<Environment>& environment,
+                     const layered_environment<OtherEnvironment>& other_environment, const int edit_distance_cutoff)
+{
+	auto similar_var = std::optional<std::string>{};
+	auto similar_var_edit_dist = edit_distance_cutoff + 1;
+	update_similar_env_var(var_name, environment, similar_var, similar_var_edit_dist);
+	update_similar_env_var(var_name, other_environment, similar_var, similar_var_edit_dist);
+	return similar_var;
+}
+
+// Looks for similar variables for multiple names in a single pass over the environment. Returns the most similar
+// variable for each name, given as pairs of name and edit distance cutoff, in the same order.
+template <typename Environment>
+[[nodiscard]] std::vector<std::optional<std::string>>
+find_similar_env_vars(const std::vector<std::pair<std::string_view, int>>& var_names_and_cutoffs,
+                      const layered_environment<Environment>& environment)
+{
+	auto similar_vars = std::vector<std::optional<std::string>>(var_names_and_cutoffs.size());
+	auto similar_var_edit_dists = std::vector<int>{};
+	similar_var_edit_dists.reserve(var_names_and_cutoffs.size());
+	for (const auto& [_, edit_distance_cutoff] : var_names_and_cutoffs) {
+		similar_var_edit_dists.push_back(edit_distance_cutoff + 1);
+	}
+
+	environment.for_each([&](const std::string_view name, const std::string_view) {
+		for (std::size_t i = 0; i < var_names_and_cutoffs.size(); ++i) {
+			const auto edit_dist =
+			    bounded_edit_distance(var_names_and_cutoffs[i].first, name, similar_var_edit_dists[i]);
+			if (edit_dist < similar_var_edit_dists[i]) {
+				similar_vars[i] = std::string(name);
+				similar_var_edit_dists[i] = edit_dist;
+			}
+		}
+	});
+	return similar_vars;
+}
 
-std::optional<std::string> pop_from_environment(const std::string_view env_var,
-                                                std::unordered_map<std::string, std::string>& environment);
+template <typename Environment>
+std::optional<std::string_view> pop_from_environment(const std::string_view env_var,
+                                                     layered_environment<Environment>& environment)
+{
+	return pop_from_environment(env_var, hash_env_var_name(env_var), environment);
+}
+
+// Same as 'pop_from_environment', but using the precomputed 'hash' of 'env_var'.
+template <typename Environment>
+std::optional<std::string_view> pop_from_environment(const std::string_view env_var, const std::size_t hash,
+                                                     layered_environment<Environment>& environment)
+{
+	const auto value = environment.find(env_var, hash);
+	if (value.has_value()) {
+		environment.consume(env_var, hash);
+	}
+	return value;
+}
 
 } // namespace env::detail
+
+namespace env {
+
+// Outdates the process-wide snapshot of the environment used by 'get' to find similar variables, and by
+// 'prefix::parse_and_validate', so that it is rebuilt on next use. Changes made through the library do this
+// automatically, this is only needed after the environment was changed by other means, e.g. by calling setenv directly.
+void refresh_snapshot() noexcept;
+
+} // namespace env
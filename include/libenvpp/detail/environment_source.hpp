@@ -0,0 +1,96 @@
+#pragma once
+
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace env {
+namespace detail {
+
+template <typename Environment, typename = void>
+struct has_string_view_find : std::false_type {
+};
+
+template <typename Environment>
+struct has_string_view_find<
+    Environment, std::void_t<decltype(std::declval<const Environment&>().find(std::declval<std::string_view>()))>>
+    : std::true_type {
+};
+
+template <typename Environment>
+inline constexpr auto has_string_view_find_v = has_string_view_find<Environment>::value;
+
+template <typename Environment, typename = void>
+struct has_key_type_find : std::false_type {
+};
+
+template <typename Environment>
+struct has_key_type_find<Environment,
+                         std::void_t<decltype(std::declval<const Environment&>().find(
+                             std::declval<const typename Environment::key_type&>()))>> : std::true_type {
+};
+
+template <typename Environment>
+inline constexpr auto has_key_type_find_v = has_key_type_find<Environment>::value;
+
+// Converts the result of a member 'find', which is either an optional value or a map iterator, into an optional value.
+template <typename Environment, typename FindResult>
+[[nodiscard]] std::optional<std::string_view> find_result_to_value(const Environment& environment,
+                                                                   const FindResult& find_result)
+{
+	if constexpr (std::is_constructible_v<std::optional<std::string_view>, FindResult>) {
+		return find_result;
+	} else {
+		if (find_result == environment.end()) {
+			return std::nullopt;
+		}
+		return std::string_view(find_result->second);
+	}
+}
+
+} // namespace detail
+
+// Customization point for environments passed to 'prefix::parse_and_validate'. An environment source must support
+// looking up the value of a variable by name, and iterating over all variables.
+//
+// The default implementation supports any range of name/value pairs whose elements can be converted to
+// 'std::string_view', e.g. 'std::unordered_map<std::string, std::string>' or
+// 'std::vector<std::pair<std::string_view, std::string_view>>'. Lookups use a member 'find' taking a
+// 'std::string_view' if available (transparent maps), a member 'find' taking the 'key_type' otherwise (maps), and a
+// linear search as the last resort. Specialize this template to provide a faster lookup, e.g. a binary search for
+// sorted ranges, or to support environments which are not ranges at all.
+//
+// Sources are never modified and do not need to be copyable. Variables consumed while parsing are tracked by the
+// library, so the same source can be used to parse and validate multiple prefixes.
+template <typename Environment>
+struct environment_source {
+	// Returns the value of the variable 'name', or std::nullopt if it is not contained in the environment.
+	[[nodiscard]] std::optional<std::string_view> find(const Environment& environment,
+	                                                   const std::string_view name) const
+	{
+		if constexpr (detail::has_string_view_find_v<Environment>) {
+			return detail::find_result_to_value(environment, environment.find(name));
+		} else if constexpr (detail::has_key_type_find_v<Environment>) {
+			return detail::find_result_to_value(environment, environment.find(typename Environment::key_type(name)));
+		} else {
+			for (const auto& [var_name, var_value] : environment) {
+				if (std::string_view(var_name) == name) {
+					return std::string_view(var_value);
+				}
+			}
+			return std::nullopt;
+		}
+	}
+
+	// Invokes 'fn(name, value)' with 'std::string_view's for every variable in the environment.
+	template <typename Fn>
+	void for_each(const Environment& environment, Fn&& fn) const
+	{
+		for (const auto& [var_name, var_value] : environment) {
+			fn(std::string_view(var_name), std::string_view(var_value));
+		}
+	}
+};
+
+} // namespace env
@@ -1,11 +1,10 @@
 #pragma once
 
 #include <cstddef>
-#include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
-#include <unordered_map>
+#include <vector>
 
 namespace env {
 
@@ -33,6 +32,12 @@ class invalid_range : public std::invalid_argument {
 	invalid_range(const std::string_view message) : std::invalid_argument(std::string(message)) {}
 };
 
+class invalid_delimiters : public std::invalid_argument {
+  public:
+	invalid_delimiters() = delete;
+	invalid_delimiters(const std::string_view message) : std::invalid_argument(std::string(message)) {}
+};
+
 class parser_error : public std::runtime_error {
   public:
 	parser_error() = delete;
@@ -69,6 +74,18 @@ class invalid_prefix : public std::runtime_error {
 	invalid_prefix(const std::string_view message) : std::runtime_error(std::string(message)) {}
 };
 
+class invalid_variable_name : public std::invalid_argument {
+  public:
+	invalid_variable_name() = delete;
+	invalid_variable_name(const std::string_view message) : std::invalid_argument(std::string(message)) {}
+};
+
+class duplicate_variable : public std::invalid_argument {
+  public:
+	duplicate_variable() = delete;
+	duplicate_variable(const std::string_view message) : std::invalid_argument(std::string(message)) {}
+};
+
 class test_environment_error : public std::runtime_error {
   public:
 	test_environment_error() = delete;
@@ -103,12 +120,15 @@ class error {
 
 namespace detail {
 
-[[nodiscard]] std::optional<error> get_similar_env_var_error(const std::size_t id, const std::string_view env_var_name,
-                                                             const int edit_dist_cutoff,
-                                                             std::unordered_map<std::string, std::string>& environment);
+[[nodiscard]] error get_similar_env_var_error(const std::size_t id, const std::string_view env_var_name,
+                                              const std::string_view similar_env_var_name);
 
 [[nodiscard]] error get_unset_env_var_error(const std::size_t id, const std::string_view env_var_name);
 
+// Formats one line per error or warning, e.g. for 'error_message' and 'warning_message'.
+[[nodiscard]] std::string format_messages(const std::string_view message_type,
+                                          const std::vector<error>& errors_or_warnings);
+
 } // namespace detail
 
 } // namespace env
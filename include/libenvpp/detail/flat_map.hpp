@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace env {
+
+// Map which stores its entries sorted by key in a single contiguous vector, which makes it cheaper to build and to
+// iterate than a 'std::map' for the small maps typically stored in environment variables. Inserting keeps the entries
+// sorted, which is fastest if entries are inserted in order.
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class flat_map {
+  public:
+	using key_type = Key;
+	using mapped_type = T;
+	using value_type = std::pair<Key, T>;
+	using key_compare = Compare;
+	using size_type = std::size_t;
+	using iterator = typename std::vector<value_type>::iterator;
+	using const_iterator = typename std::vector<value_type>::const_iterator;
+
+	flat_map() = default;
+
+	flat_map(std::initializer_list<value_type> entries)
+	{
+		m_entries.reserve(entries.size());
+		for (const auto& entry : entries) {
+			insert(entry);
+		}
+	}
+
+	[[nodiscard]] iterator begin() noexcept { return m_entries.begin(); }
+	[[nodiscard]] const_iterator begin() const noexcept { return m_entries.begin(); }
+	[[nodiscard]] iterator end() noexcept { return m_entries.end(); }
+	[[nodiscard]] const_iterator end() const noexcept { return m_entries.end(); }
+
+	[[nodiscard]] bool empty() const noexcept { return m_entries.empty(); }
+	[[nodiscard]] size_type size() const noexcept { return m_entries.size(); }
+
+	void reserve(const size_type capacity) { m_entries.reserve(capacity); }
+	void clear() noexcept { m_entries.clear(); }
+
+	// Inserts the entry, unless an entry with an equivalent key already exists. Returns an iterator to the entry with
+	// the key, and whether the entry was inserted.
+	std::pair<iterator, bool> insert(value_type entry)
+	{
+		const auto it = lower_bound(entry.first);
+		if (it != m_entries.end() && !m_compare(entry.first, it->first)) {
+			return {it, false};
+		}
+		return {m_entries.insert(it, std::move(entry)), true};
+	}
+
+	template <typename... Args>
+	std::pair<iterator, bool> emplace(Args&&... args)
+	{
+		return insert(value_type(std::forward<Args>(args)...));
+	}
+
+	[[nodiscard]] iterator find(const Key& key)
+	{
+		const auto it = lower_bound(key);
+		return it != m_entries.end() && !m_compare(key, it->first) ? it : m_entries.end();
+	}
+
+	[[nodiscard]] const_iterator find(const Key& key) const
+	{
+		return const_cast<flat_map&>(*this).find(key);
+	}
+
+	[[nodiscard]] bool contains(const Key& key) const { return find(key) != end(); }
+	[[nodiscard]] size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+	[[nodiscard]] T& at(const Key& key)
+	{
+		const auto it = find(key);
+		if (it == end()) {
+			throw std::out_of_range("Key not found in flat_map");
+		}
+		return it->second;
+	}
+
+	[[nodiscard]] const T& at(const Key& key) const { return const_cast<flat_map&>(*this).at(key); }
+
+	[[nodiscard]] friend bool operator==(const flat_map& lhs, const flat_map& rhs)
+	{
+		return lhs.m_entries == rhs.m_entries;
+	}
+
+	[[nodiscard]] friend bool operator!=(const flat_map& lhs, const flat_map& rhs) { return !(lhs == rhs); }
+
+  private:
+	[[nodiscard]] iterator lower_bound(const Key& key)
+	{
+		// Entries are usually inserted in order, in which case the new entry belongs at the end.
+		if (m_entries.empty() || m_compare(m_entries.back().first, key)) {
+			return m_entries.end();
+		}
+		return std::lower_bound(m_entries.begin(), m_entries.end(), key,
+		                        [&](const value_type& entry, const Key& k) { return m_compare(entry.first, k); });
+	}
+
+	std::vector<value_type> m_entries;
+	Compare m_compare;
+};
+
+} // namespace env
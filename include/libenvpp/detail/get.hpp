@@ -1,8 +1,13 @@
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <optional>
+#include <string>
 #include <string_view>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include <libenvpp/detail/edit_distance.hpp>
 #include <libenvpp/detail/environment.hpp>
@@ -13,43 +18,166 @@
 
 namespace env {
 
+namespace detail {
+
+inline constexpr auto prefixless_id = static_cast<std::size_t>(-1);
+
+// Looks up a single variable directly, giving precedence to the global testing environment, without reading the whole
+// environment.
+[[nodiscard]] inline std::optional<std::string> find_env_var(const std::string_view env_var_name)
+{
+	if (!g_testing_environment.empty()) {
+		if (const auto it = g_testing_environment.find(std::string(env_var_name)); it != g_testing_environment.end()) {
+			return it->second;
+		}
+	}
+	return get_environment_variable(env_var_name);
+}
+
+// Finds the values of multiple variables in a single pass over the environment, giving precedence to the global testing
+// environment. The values point into the testing environment or 'system_environment'.
+template <std::size_t N>
+[[nodiscard]] std::array<std::optional<std::string_view>, N>
+find_env_vars(const std::array<std::string_view, N>& env_var_names, const environment_view& system_environment)
+{
+	auto values = std::array<std::optional<std::string_view>, N>{};
+	auto num_missing = N;
+	if (!g_testing_environment.empty()) {
+		for (std::size_t i = 0; i < N; ++i) {
+			if (const auto it = g_testing_environment.find(std::string(env_var_names[i]));
+			    it != g_testing_environment.end()) {
+				values[i] = it->second;
+				--num_missing;
+			}
+		}
+	}
+
+	for (auto var = system_environment.begin(); num_missing > 0 && var != system_environment.end(); ++var) {
+		const auto [name, value] = *var;
+		for (std::size_t i = 0; i < N; ++i) {
+			if (!values[i].has_value() && env_var_names[i] == name) {
+				values[i] = value;
+				--num_missing;
+			}
+		}
+	}
+	return values;
+}
+
 template <typename T>
-[[nodiscard]] expected<T, error> get(const std::string_view env_var_name,
-                                     const edit_distance edit_distance_cutoff = default_edit_distance)
+[[nodiscard]] expected<T, error> parse_env_var(const std::string_view env_var_name,
+                                               const std::string_view env_var_value)
 {
+	// Prefixless variables are not backed by a snapshot which outlives them, so their values must own their data.
+	static_assert(!is_borrowed_string_v<T>, "Borrowed string types are not supported for prefixless variables");
+
 	using expected_t = expected<T, error>;
 	using unexpected_t = typename expected_t::unexpected_type;
 
-	// Merges the global testing environment into the environment considered for parsing and validating,
-	// giving precedence to variables set in the testing environment.
-	auto environment = detail::merge_environments(detail::g_testing_environment, detail::get_environment());
+	auto res = parse_or_error<T>(env_var_name, env_var_value, default_parser_and_validator<T>{});
+	if (res.has_value()) {
+		return expected_t{std::move(res).value()};
+	}
+	return expected_t{unexpected_t{error(prefixless_id, env_var_name, std::move(res).error())}};
+}
 
-	if (const auto env_var_it = environment.find(std::string(env_var_name)); env_var_it != environment.end()) {
-		auto res = detail::parse_or_error<T>(env_var_name, env_var_it->second, default_parser_and_validator<T>{});
-		if (res.has_value()) {
-			return expected_t{std::move(res).value()};
-		}
-		return expected_t{unexpected_t{error(static_cast<std::size_t>(-1), env_var_name, std::move(res).error())}};
+template <typename T>
+[[nodiscard]] expected<T, error> get_missing_env_var_error(const std::string_view env_var_name,
+                                                           const std::optional<std::string>& similar_env_var)
+{
+	using expected_t = expected<T, error>;
+	using unexpected_t = typename expected_t::unexpected_type;
+
+	if (similar_env_var.has_value()) {
+		return expected_t{unexpected_t{get_similar_env_var_error(prefixless_id, env_var_name, *similar_env_var)}};
+	}
+	return expected_t{unexpected_t{get_unset_env_var_error(prefixless_id, env_var_name)}};
+}
+
+template <typename T>
+using env_var_name_t = std::string_view;
+
+template <typename T>
+[[nodiscard]] expected<T, error> get_env_var_result(const std::string_view env_var_name,
+                                                    const std::optional<std::string_view>& env_var_value,
+                                                    const std::optional<std::string>& similar_env_var)
+{
+	if (env_var_value.has_value()) {
+		return parse_env_var<T>(env_var_name, *env_var_value);
+	}
+	return get_missing_env_var_error<T>(env_var_name, similar_env_var);
+}
+
+template <typename... Ts, std::size_t N, std::size_t... Is>
+[[nodiscard]] std::tuple<expected<Ts, error>...>
+get_many_results(const std::array<std::string_view, N>& env_var_names,
+                 const std::array<std::optional<std::string_view>, N>& env_var_values,
+                 const std::array<std::optional<std::string>, N>& similar_env_vars, std::index_sequence<Is...>)
+{
+	return {get_env_var_result<Ts>(env_var_names[Is], env_var_values[Is], similar_env_vars[Is])...};
+}
+
+} // namespace detail
+
+template <typename T>
+[[nodiscard]] expected<T, error> get(const std::string_view env_var_name,
+                                     const edit_distance edit_distance_cutoff = default_edit_distance)
+{
+	if (const auto env_var_value = detail::find_env_var(env_var_name); env_var_value.has_value()) {
+		return detail::parse_env_var<T>(env_var_name, *env_var_value);
 	}
 
-	const auto id = static_cast<std::size_t>(-1);
+	// Only if the variable is not set the whole environment is needed, to look for similarly named variables. Layers
+	// the global testing environment on top of it, giving precedence to variables set in the testing environment.
+	const auto system_environment = detail::get_environment_snapshot();
+	const auto environment = detail::layered_environment(detail::g_testing_environment, *system_environment);
+
 	const auto edit_dist_cutoff = edit_distance_cutoff.get_or_default(env_var_name.length());
-	auto similar_env_var_error = detail::get_similar_env_var_error(id, env_var_name, edit_dist_cutoff, environment);
-	if (similar_env_var_error.has_value()) {
-		return expected_t{unexpected_t{std::move(similar_env_var_error).value()}};
+	const auto similar_env_var = detail::find_similar_env_var(env_var_name, environment, edit_dist_cutoff);
+	return detail::get_missing_env_var_error<T>(env_var_name, similar_env_var);
+}
+
+// Parses and validates multiple variables at once, e.g. 'get_many<std::string, int>("HOME", "OMP_NUM_THREADS")',
+// returning a tuple with one result per variable, as if each was retrieved with 'get'. The environment is only read
+// once, and similarly named variables are looked for in a single pass for all variables which are not set.
+template <typename... Ts>
+[[nodiscard]] std::tuple<expected<Ts, error>...> get_many(const detail::env_var_name_t<Ts>... env_var_names)
+{
+	constexpr auto num_vars = sizeof...(Ts);
+	const auto names = std::array<std::string_view, num_vars>{env_var_names...};
+
+	const auto system_environment = detail::get_environment_view();
+	const auto values = detail::find_env_vars(names, system_environment);
+
+	auto missing_names_and_cutoffs = std::vector<std::pair<std::string_view, int>>{};
+	for (std::size_t i = 0; i < num_vars; ++i) {
+		if (!values[i].has_value()) {
+			missing_names_and_cutoffs.emplace_back(names[i], default_edit_distance.get_or_default(names[i].length()));
+		}
 	}
-	return expected_t{unexpected_t{detail::get_unset_env_var_error(id, env_var_name)}};
+
+	auto similar_env_vars = std::array<std::optional<std::string>, num_vars>{};
+	if (!missing_names_and_cutoffs.empty()) {
+		const auto environment = detail::layered_environment(detail::g_testing_environment, system_environment);
+		auto missing_similar_env_vars = detail::find_similar_env_vars(missing_names_and_cutoffs, environment);
+		for (std::size_t i = 0, missing_idx = 0; i < num_vars; ++i) {
+			if (!values[i].has_value()) {
+				similar_env_vars[i] = std::move(missing_similar_env_vars[missing_idx++]);
+			}
+		}
+	}
+
+	return detail::get_many_results<Ts...>(names, values, similar_env_vars, std::index_sequence_for<Ts...>{});
 }
 
 template <typename T, typename U = T>
 [[nodiscard]] T get_or(const std::string_view env_var_name, U&& default_value)
 {
-	// Merges the global testing environment into the environment considered for parsing and validating,
-	// giving precedence to variables set in the testing environment.
-	const auto environment = detail::merge_environments(detail::g_testing_environment, detail::get_environment());
+	static_assert(!detail::is_borrowed_string_v<T>, "Borrowed string types are not supported for prefixless variables");
 
-	if (const auto env_var_it = environment.find(std::string(env_var_name)); env_var_it != environment.end()) {
-		auto res = detail::parse_or_error<T>(env_var_name, env_var_it->second, default_parser_and_validator<T>{});
+	// No similar variables are reported, so the whole environment is never needed.
+	if (const auto env_var_value = detail::find_env_var(env_var_name); env_var_value.has_value()) {
+		auto res = detail::parse_or_error<T>(env_var_name, *env_var_value, default_parser_and_validator<T>{});
 		if (res.has_value()) {
 			return std::move(res).value();
 		}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace env::detail {
+
+[[nodiscard]] inline std::size_t hash_env_var_name(const std::string_view name) noexcept
+{
+	return std::hash<std::string_view>{}(name);
+}
+
+// Full names of all variables of a prefix, i.e. the prefix name followed by the variable name, which are built and
+// hashed once while registering the variables. All names are stored contiguously, so the names are only referred to by
+// offset and are valid for as long as the pool, even after moving it.
+class name_pool {
+	struct entry {
+		std::size_t offset;
+		std::size_t length;
+		std::size_t hash;
+	};
+
+  public:
+	name_pool() = default;
+	explicit name_pool(std::string prefix_name) : m_prefix_name(std::move(prefix_name)) {}
+
+	// Adds the full name of the variable 'name', returns the index of the name.
+	std::size_t add(const std::string_view name)
+	{
+		const auto offset = m_storage.size();
+		m_storage.append(m_prefix_name);
+		m_storage.append(name);
+		const auto length = m_storage.size() - offset;
+		m_entries.push_back({offset, length, hash_env_var_name(std::string_view(m_storage).substr(offset, length))});
+		return m_entries.size() - 1;
+	}
+
+	[[nodiscard]] std::size_t size() const noexcept { return m_entries.size(); }
+
+	[[nodiscard]] const std::string& prefix_name() const noexcept { return m_prefix_name; }
+
+	// Full name including the prefix name.
+	[[nodiscard]] std::string_view full_name(const std::size_t idx) const noexcept
+	{
+		return std::string_view(m_storage).substr(m_entries[idx].offset, m_entries[idx].length);
+	}
+
+	// Name of the variable as registered, without the prefix name.
+	[[nodiscard]] std::string_view name(const std::size_t idx) const noexcept
+	{
+		return full_name(idx).substr(m_prefix_name.size());
+	}
+
+	[[nodiscard]] std::size_t hash(const std::size_t idx) const noexcept { return m_entries[idx].hash; }
+
+  private:
+	std::string m_prefix_name;
+	std::string m_storage;
+	std::vector<entry> m_entries;
+};
+
+} // namespace env::detail
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace env::detail {
+
+// Options of an option variable, sorted once at registration, so that looking up options by value or by string is a
+// binary search, which does not allocate. Each option is only stored once, and the table is small enough for option
+// parsers to be stored inline in 'parser_and_validator_fn'.
+template <typename T>
+class option_table {
+	struct option_string {
+		std::string string;
+		// Index of the option in the sorted options.
+		std::size_t option_idx;
+		// Index of the option in the order in which the options were given.
+		std::size_t position;
+	};
+
+  public:
+	// 'option_strings' is either empty, or contains the string of each option in 'options' at the same index.
+	option_table(std::vector<T> options, std::vector<std::string> option_strings = {})
+	{
+		auto sorted_indices = std::vector<std::size_t>(options.size());
+		std::iota(sorted_indices.begin(), sorted_indices.end(), std::size_t{0});
+		std::stable_sort(sorted_indices.begin(), sorted_indices.end(),
+		                 [&](const std::size_t lhs, const std::size_t rhs) { return options[lhs] < options[rhs]; });
+
+		m_option_strings.reserve(option_strings.size());
+		for (std::size_t i = 0; i < option_strings.size(); ++i) {
+			m_option_strings.push_back({std::move(option_strings[i]), 0, i});
+		}
+		m_sorted_options.reserve(options.size());
+		for (const auto idx : sorted_indices) {
+			if (idx < m_option_strings.size()) {
+				m_option_strings[idx].option_idx = m_sorted_options.size();
+			}
+			m_sorted_options.push_back(std::move(options[idx]));
+		}
+		// Stable, so that the first of several equal option strings is found.
+		std::stable_sort(m_option_strings.begin(), m_option_strings.end(),
+		                 [](const option_string& lhs, const option_string& rhs) { return lhs.string < rhs.string; });
+	}
+
+	[[nodiscard]] bool empty() const noexcept { return m_sorted_options.empty(); }
+
+	[[nodiscard]] bool has_duplicates() const
+	{
+		return std::adjacent_find(m_sorted_options.begin(), m_sorted_options.end(), [](const T& lhs, const T& rhs) {
+			       return !(lhs < rhs) && !(rhs < lhs);
+		       }) != m_sorted_options.end();
+	}
+
+	[[nodiscard]] bool contains(const T& value) const
+	{
+		return std::binary_search(m_sorted_options.begin(), m_sorted_options.end(), value);
+	}
+
+	// Returns the option whose string is 'str', or nullptr if there is none.
+	[[nodiscard]] const T* find(const std::string_view str) const
+	{
+		const auto it = std::lower_bound(
+		    m_option_strings.begin(), m_option_strings.end(), str,
+		    [](const option_string& option, const std::string_view value) { return option.string < value; });
+		if (it == m_option_strings.end() || it->string != str) {
+			return nullptr;
+		}
+		return &m_sorted_options[it->option_idx];
+	}
+
+	// Option strings in the order in which they were given.
+	[[nodiscard]] std::vector<std::string_view> option_strings() const
+	{
+		auto option_strings = std::vector<std::string_view>(m_option_strings.size());
+		for (const auto& option : m_option_strings) {
+			option_strings[option.position] = option.string;
+		}
+		return option_strings;
+	}
+
+  private:
+	std::vector<T> m_sorted_options;
+	// Sorted by string.
+	std::vector<option_string> m_option_strings;
+};
+
+} // namespace env::detail
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
+namespace env {
+
+// Customization point for types with a fixed set of options, e.g. 'enum class' types. Specializations must provide
+// a static constexpr array of pairs of option names and values named 'options', for example:
+//
+//   template <>
+//   struct env::option_traits<mode> {
+//       static constexpr auto options = std::array{std::pair{std::string_view("fast"), mode::fast},
+//                                                  std::pair{std::string_view("safe"), mode::safe}};
+//   };
+template <typename T>
+struct option_traits {
+};
+
+namespace detail {
+
+template <typename T, typename = void>
+struct has_option_traits : std::false_type {
+};
+
+template <typename T>
+struct has_option_traits<T, std::void_t<decltype(option_traits<T>::options)>> : std::true_type {
+};
+
+template <typename T>
+inline constexpr auto has_option_traits_v = has_option_traits<T>::value;
+
+// Indices of 'options' sorted by option name. Insertion sort, as 'std::sort' is not constexpr in C++17.
+template <typename Options>
+[[nodiscard]] constexpr auto sort_options_by_name(const Options& options)
+{
+	auto indices = std::array<std::size_t, std::tuple_size_v<Options>>{};
+	for (std::size_t i = 0; i < indices.size(); ++i) {
+		auto j = i;
+		for (; j > 0 && options[i].first < options[indices[j - 1]].first; --j) {
+			indices[j] = indices[j - 1];
+		}
+		indices[j] = i;
+	}
+	return indices;
+}
+
+template <typename Options>
+[[nodiscard]] constexpr bool has_empty_option_names(const Options& options)
+{
+	for (const auto& option : options) {
+		if (option.first.empty()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+template <typename Options, typename Indices>
+[[nodiscard]] constexpr bool has_duplicate_option_names(const Options& options, const Indices& sorted_indices)
+{
+	for (std::size_t i = 1; i < sorted_indices.size(); ++i) {
+		if (options[sorted_indices[i - 1]].first == options[sorted_indices[i]].first) {
+			return true;
+		}
+	}
+	return false;
+}
+
+template <typename Options>
+[[nodiscard]] constexpr bool has_duplicate_option_values(const Options& options)
+{
+	for (std::size_t i = 0; i < std::size(options); ++i) {
+		for (std::size_t j = i + 1; j < std::size(options); ++j) {
+			if (options[i].second == options[j].second) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+template <typename Options>
+[[nodiscard]] constexpr auto get_option_names(const Options& options)
+{
+	auto names = std::array<std::string_view, std::tuple_size_v<Options>>{};
+	for (std::size_t i = 0; i < names.size(); ++i) {
+		names[i] = options[i].first;
+	}
+	return names;
+}
+
+// Options given by 'option_traits<T>', checked and sorted by name at compile time, so that options are looked up by a
+// binary search without any tables being built at runtime.
+template <typename T>
+class static_option_table {
+	static constexpr auto& options = option_traits<T>::options;
+	static constexpr auto sorted_indices = sort_options_by_name(options);
+
+	static_assert(std::size(options) > 0, "Option traits must provide at least one option");
+	static_assert(!has_empty_option_names(options), "Option names must not be empty");
+	static_assert(!has_duplicate_option_names(options, sorted_indices), "Option names must be unique");
+	static_assert(!has_duplicate_option_values(options), "Option values must be unique");
+
+  public:
+	// Names of all options in the order in which they are given by the option traits.
+	static constexpr auto names = get_option_names(options);
+
+	// Returns the option named 'str', or nullptr if there is none.
+	[[nodiscard]] static const T* find(const std::string_view str) noexcept
+	{
+		const auto it = std::lower_bound(
+		    sorted_indices.begin(), sorted_indices.end(), str,
+		    [](const std::size_t idx, const std::string_view value) { return options[idx].first < value; });
+		if (it == sorted_indices.end() || options[*it].first != str) {
+			return nullptr;
+		}
+		return &options[*it].second;
+	}
+};
+
+} // namespace detail
+
+} // namespace env
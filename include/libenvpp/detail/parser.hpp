@@ -1,22 +1,54 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <exception>
+#include <limits>
+#include <locale>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <set>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <system_error>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
+#if __has_include(<version>)
+#include <version>
+#endif
+#if defined(__cpp_lib_span)
+#include <span>
+#endif
+
+#include <fmt/chrono.h>
 #include <fmt/format.h>
 
+#include <libenvpp/detail/byte_size.hpp>
+#include <libenvpp/detail/bytes.hpp>
 #include <libenvpp/detail/errors.hpp>
 #include <libenvpp/detail/expected.hpp>
+#include <libenvpp/detail/flat_map.hpp>
 #include <libenvpp/detail/util.hpp>
 
 namespace env {
+
+template <typename T>
+struct default_validator;
+
+template <typename T>
+struct default_parser;
+
 namespace detail {
 
 template <typename T>
@@ -30,6 +62,24 @@ struct is_string_constructible : std::conditional_t<
 template <typename T>
 inline constexpr auto is_string_constructible_v = is_string_constructible<T>::value;
 
+// Types which refer to the parsed string instead of owning a copy of it.
+template <typename T>
+struct is_borrowed_string : std::false_type {
+};
+
+template <>
+struct is_borrowed_string<std::string_view> : std::true_type {
+};
+
+#if defined(__cpp_lib_span)
+template <>
+struct is_borrowed_string<std::span<const char>> : std::true_type {
+};
+#endif
+
+template <typename T>
+inline constexpr auto is_borrowed_string_v = is_borrowed_string<T>::value;
+
 //////////////////////////////////////////////////////////////////////////
 
 template <typename T, typename = void>
@@ -55,40 +105,780 @@ inline constexpr auto is_stringstream_constructible_v = is_stringstream_construc
 
 //////////////////////////////////////////////////////////////////////////
 
+template <typename T>
+struct is_character : std::disjunction<std::is_same<T, char>, std::is_same<T, signed char>,
+                                       std::is_same<T, unsigned char>, std::is_same<T, wchar_t>,
+                                       std::is_same<T, char16_t>, std::is_same<T, char32_t>> {
+};
+
+// Arithmetic types are parsed with std::from_chars, except for bool which is matched by hand, and character types,
+// which keep the single character semantics of operator>>.
+template <typename T>
+struct is_from_chars_parsable
+    : std::conjunction<std::is_arithmetic<T>, std::negation<std::is_same<T, bool>>, std::negation<is_character<T>>> {
+};
+
+template <typename T>
+inline constexpr auto is_from_chars_parsable_v = is_from_chars_parsable<T>::value;
+
+//////////////////////////////////////////////////////////////////////////
+
+// Same set of whitespace characters as skipped by operator>> in the classic locale.
+[[nodiscard]] constexpr bool is_space(const char c) noexcept
+{
+	return c == ' ' || ('\t' <= c && c <= '\r');
+}
+
+[[nodiscard]] constexpr bool is_digit(const char c) noexcept
+{
+	return '0' <= c && c <= '9';
+}
+
+[[nodiscard]] constexpr std::string_view trim_spaces(std::string_view str) noexcept
+{
+	while (!str.empty() && is_space(str.front())) {
+		str.remove_prefix(1);
+	}
+	while (!str.empty() && is_space(str.back())) {
+		str.remove_suffix(1);
+	}
+	return str;
+}
+
+// Case-insensitively matches the words accepted as boolean values, without any allocation.
+[[nodiscard]] constexpr std::optional<bool> match_bool(const std::string_view str) noexcept
+{
+	constexpr auto max_length = std::size_t{5};
+	if (str.empty() || str.size() > max_length) {
+		return std::nullopt;
+	}
+
+	// Setting the 0x20 bit maps upper to lower case letters, and never maps any other character to a letter.
+	char lower[max_length] = {};
+	for (std::size_t i = 0; i < str.size(); ++i) {
+		lower[i] = static_cast<char>(str[i] | 0x20);
+	}
+	const auto word = std::string_view(lower, str.size());
+
+	if (word == "true" || word == "on" || word == "yes") {
+		return true;
+	}
+	if (word == "false" || word == "off" || word == "no") {
+		return false;
+	}
+	return std::nullopt;
+}
+
 [[nodiscard]] inline bool parse_bool(const std::string_view str)
 {
-	constexpr auto to_lower_char = [](const char c) -> char {
-		if ('A' <= c && c <= 'Z') {
-			return c + ('a' - 'A');
-		} else {
-			return c;
+	const auto trimmed = trim_spaces(str);
+
+	// Like operator>>, integers are accepted as well, if their value is either 0 or 1.
+	const auto has_sign = !trimmed.empty() && (trimmed.front() == '+' || trimmed.front() == '-');
+	const auto digits = trimmed.substr(has_sign ? 1 : 0);
+	if (!digits.empty() && std::all_of(digits.begin(), digits.end(), is_digit)) {
+		const auto significant_digits = digits.substr(std::min(digits.find_first_not_of('0'), digits.size()));
+		if (significant_digits.empty()) {
+			return false;
 		}
-	};
+		if (significant_digits == "1" && trimmed.front() != '-') {
+			return true;
+		}
+	} else if (const auto value = match_bool(trimmed); value.has_value()) {
+		return *value;
+	}
+	throw parser_error{fmt::format("Failed to parse '{}' as boolean", str)};
+}
+
+#if LIBENVPP_CLASSIC_LOCALE
+inline constexpr auto use_classic_locale = true;
+#else
+inline constexpr auto use_classic_locale = false;
+#endif
+
+// Input stream which is constructed once per thread and reused for parsing, together with a buffer for its input, and
+// the locale the stream is imbued with.
+struct reusable_istringstream {
+	std::istringstream stream;
+	std::string buffer;
+	std::locale locale;
+	bool is_in_use = false;
+};
+
+template <bool UseClassicLocale>
+[[nodiscard]] reusable_istringstream& get_reusable_istringstream()
+{
+	thread_local auto reusable = [] {
+		auto r = reusable_istringstream{};
+		if constexpr (UseClassicLocale) {
+			r.locale = std::locale::classic();
+		}
+		r.stream.imbue(r.locale);
+		return r;
+	}();
+	return reusable;
+}
+
+// Invokes 'fn' with an input stream containing 'str', which is imbued with either the classic or the global locale.
+// The stream is reused across invocations on the same thread, with its state and formatting flags reset, so no stream
+// has to be constructed. The input is copied into the stream's existing buffer, which only allocates if the input is
+// longer than any before it. Nested invocations, e.g. from within a custom operator>>, use a new stream instead.
+template <bool UseClassicLocale, typename Fn>
+decltype(auto) with_reusable_stream(const std::string_view str, Fn&& fn)
+{
+	auto& reusable = get_reusable_istringstream<UseClassicLocale>();
+
+	if (reusable.is_in_use) {
+		auto stream = std::istringstream(std::string(str));
+		if constexpr (UseClassicLocale) {
+			stream.imbue(std::locale::classic());
+		}
+		return fn(stream);
+	}
 
-	constexpr auto equal_case_insensitive = [to_lower_char](const std::string_view a, const std::string_view b) {
-		return std::equal(a.begin(), a.end(), b.begin(), b.end(),
-		                  [to_lower_char](const char a, const char b) { return to_lower_char(a) == to_lower_char(b); });
+	struct stream_lease {
+		explicit stream_lease(bool& is_in_use) : m_is_in_use(is_in_use) { m_is_in_use = true; }
+		~stream_lease() { m_is_in_use = false; }
+		bool& m_is_in_use;
 	};
+	const auto lease = stream_lease(reusable.is_in_use);
 
-	if (equal_case_insensitive(str, "true")  //
-	    || equal_case_insensitive(str, "on") //
-	    || equal_case_insensitive(str, "yes")) {
+	auto& stream = reusable.stream;
+	if constexpr (!UseClassicLocale) {
+		// Follows changes of the global locale, like a newly constructed stream would. Getting the global locale still
+		// copies it, but the stream is only imbued again if it changed.
+		if (auto global_locale = std::locale(); global_locale != reusable.locale) {
+			reusable.locale = std::move(global_locale);
+		}
+	}
+
+	// Resets everything a previous parse, or a custom operator>>, might have changed.
+	if (stream.getloc() != reusable.locale) {
+		stream.imbue(reusable.locale);
+	}
+	stream.exceptions(std::ios_base::goodbit);
+	stream.clear();
+	stream.flags(std::ios_base::skipws | std::ios_base::dec);
+	stream.width(0);
+	stream.precision(6);
+	reusable.buffer.assign(str.data(), str.size());
+	stream.str(reusable.buffer);
+	return fn(stream);
+}
+
+// Invokes 'fn' with an input stream containing 'str', which is imbued with the classic locale.
+template <typename Fn>
+decltype(auto) with_classic_locale_stream(const std::string_view str, Fn&& fn)
+{
+	return with_reusable_stream<true>(str, std::forward<Fn>(fn));
+}
+
+// Invokes 'fn' with an input stream containing 'str'. If LIBENVPP_CLASSIC_LOCALE is enabled, the stream is imbued with
+// the classic locale, otherwise it uses the global locale.
+template <typename Fn>
+decltype(auto) with_input_stream(const std::string_view str, Fn&& fn)
+{
+	return with_reusable_stream<use_classic_locale>(str, std::forward<Fn>(fn));
+}
+
+// Parses a floating-point number using operator>> with the classic locale, reporting the result like std::from_chars.
+template <typename T>
+[[nodiscard]] std::from_chars_result floating_point_from_stream(const char* const first, const char* const last,
+                                                                T& value)
+{
+	const auto str = std::string_view(first, static_cast<std::size_t>(last - first));
+	return with_classic_locale_stream(str, [&](std::istringstream& stream) -> std::from_chars_result {
+		stream >> value;
+		if (stream.fail()) {
+			return {first, std::errc::invalid_argument};
+		}
+		if (stream.eof()) {
+			return {last, std::errc{}};
+		}
+		return {first + static_cast<std::ptrdiff_t>(stream.tellg()), std::errc{}};
+	});
+}
+
+// Equivalent to std::from_chars for floating-point types, falling back to operator>> if the standard library does not
+// support floating-point types in std::from_chars. Numbers which are too small to be represented as normalized values
+// are also parsed with operator>>, which accepts them, while std::from_chars reports them as out of range.
+template <typename T>
+[[nodiscard]] std::from_chars_result floating_point_from_chars(const char* const first, const char* const last,
+                                                               T& value)
+{
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+	const auto result = std::from_chars(first, last, value);
+	if (result.ec == std::errc::result_out_of_range) {
+		const auto stream_result = floating_point_from_stream(first, last, value);
+		if (stream_result.ec == std::errc{}) {
+			return stream_result;
+		}
+	}
+	return result;
+#else
+	return floating_point_from_stream(first, last, value);
+#endif
+}
+
+// Parses integral and floating-point types with the same semantics as operator>>, i.e. surrounding whitespace and an
+// explicit plus sign are accepted, the whole input must be consumed, and negative zero is the only negative number
+// accepted for unsigned types. In contrast to operator>>, parsing is independent of the global locale.
+template <typename T>
+[[nodiscard]] T parse_arithmetic(const std::string_view str)
+{
+	auto number = trim_spaces(str);
+	if (!number.empty() && number.front() == '+') {
+		number.remove_prefix(1);
+		if (!number.empty() && number.front() == '-') {
+			throw parser_error{fmt::format("Failed to parse '{}' as number", str)};
+		}
+	}
+
+	auto is_negative = false;
+	if constexpr (std::is_unsigned_v<T>) {
+		if (!number.empty() && number.front() == '-') {
+			number.remove_prefix(1);
+			is_negative = true;
+		}
+	}
+
+	auto value = T{};
+	const auto* const first = number.data();
+	const auto* const last = number.data() + number.size();
+	auto result = std::from_chars_result{first, std::errc::invalid_argument};
+	if constexpr (std::is_floating_point_v<T>) {
+		// Only decimal numbers are accepted, no infinity or NaN.
+		const auto mantissa = number.substr(!number.empty() && number.front() == '-' ? 1 : 0);
+		if (!mantissa.empty() && (is_digit(mantissa.front()) || mantissa.front() == '.')) {
+			result = floating_point_from_chars(first, last, value);
+		}
+	} else {
+		result = std::from_chars(first, last, value);
+	}
+
+	if (result.ec == std::errc::result_out_of_range) {
+		throw parser_error{fmt::format("Input '{}' is out of range", str)};
+	}
+	if (result.ec != std::errc{}) {
+		throw parser_error{fmt::format("Failed to parse '{}' as number", str)};
+	}
+	if (result.ptr != last) {
+		throw parser_error{fmt::format("Input '{}' was only parsed partially with remaining data '{}'", str,
+		                               str.substr(static_cast<std::size_t>(result.ptr - str.data())))};
+	}
+	if (is_negative && value != 0) {
+		throw parser_error{fmt::format("Cannot parse negative number '{}' as unsigned type", str)};
+	}
+	return value;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+struct is_duration : std::false_type {
+};
+
+template <typename Rep, typename Period>
+struct is_duration<std::chrono::duration<Rep, Period>> : std::true_type {
+};
+
+// Unit suffix, whose value is 'num / den' of the base unit, i.e. of seconds for durations and of bytes for byte sizes.
+struct unit {
+	std::string_view suffix;
+	std::uint64_t num;
+	std::uint64_t den;
+};
+
+inline constexpr unit duration_units[] = {
+    {"ns", 1, 1'000'000'000}, {"us", 1, 1'000'000}, {"ms", 1, 1'000}, {"s", 1, 1}, {"m", 60, 1}, {"h", 3'600, 1},
+};
+
+inline constexpr unit byte_size_units[] = {
+    {"B", 1, 1},
+    {"KB", 1'000, 1},
+    {"KiB", std::uint64_t{1} << 10, 1},
+    {"MB", 1'000'000, 1},
+    {"MiB", std::uint64_t{1} << 20, 1},
+    {"GB", 1'000'000'000, 1},
+    {"GiB", std::uint64_t{1} << 30, 1},
+    {"TB", 1'000'000'000'000, 1},
+    {"TiB", std::uint64_t{1} << 40, 1},
+};
+
+template <std::size_t N>
+[[nodiscard]] constexpr const unit* find_unit(const unit (&units)[N], const std::string_view suffix) noexcept
+{
+	for (const auto& u : units) {
+		if (u.suffix == suffix) {
+			return &u;
+		}
+	}
+	return nullptr;
+}
+
+template <std::size_t N>
+[[nodiscard]] std::string unknown_unit_message(const unit (&units)[N], const std::string_view suffix,
+                                               const std::string_view str)
+{
+	auto suffixes = std::array<std::string_view, N>{};
+	std::transform(std::begin(units), std::end(units), suffixes.begin(), [](const unit& u) { return u.suffix; });
+	if (suffix.empty()) {
+		return fmt::format("Missing unit in '{}', should be one of [{}]", str, fmt::join(suffixes, ", "));
+	}
+	return fmt::format("Unknown unit '{}' in '{}', should be one of [{}]", suffix, str, fmt::join(suffixes, ", "));
+}
+
+// Returns whether 'lhs * rhs' overflows, and stores the product in 'result' otherwise.
+[[nodiscard]] constexpr bool multiply_overflows(const std::uint64_t lhs, const std::uint64_t rhs,
+                                                std::uint64_t& result) noexcept
+{
+	if (lhs != 0 && rhs > std::numeric_limits<std::uint64_t>::max() / lhs) {
 		return true;
-	} else if (equal_case_insensitive(str, "false")  //
-	           || equal_case_insensitive(str, "off") //
-	           || equal_case_insensitive(str, "no")) {
-		return false;
+	}
+	result = lhs * rhs;
+	return false;
+}
+
+// Splits the number at the start of 'str' off, and returns it together with the unit suffix following it, which
+// consists of everything up to the next digit, ignoring surrounding whitespace.
+[[nodiscard]] inline std::pair<std::uint64_t, std::string_view> split_number_with_unit(std::string_view& str,
+                                                                                      const std::string_view input)
+{
+	auto number = std::uint64_t{};
+	const auto result = std::from_chars(str.data(), str.data() + str.size(), number);
+	if (result.ec == std::errc::result_out_of_range) {
+		throw parser_error{fmt::format("Input '{}' is out of range", input)};
+	}
+	if (result.ec != std::errc{}) {
+		throw parser_error{fmt::format("Expected number in '{}'", input)};
+	}
+	str.remove_prefix(static_cast<std::size_t>(result.ptr - str.data()));
+	const auto suffix_end = std::find_if(str.begin(), str.end(), is_digit);
+	const auto suffix = str.substr(0, static_cast<std::size_t>(suffix_end - str.begin()));
+	str.remove_prefix(suffix.size());
+	return {number, trim_spaces(suffix)};
+}
+
+// Parses durations consisting of one or more numbers with unit suffixes, e.g. '250ms' or '1h30m', optionally preceded
+// by a minus sign for signed representations. A single '0' needs no unit. Durations which are not exactly
+// representable in an integral representation, e.g. '1us' as milliseconds, and overflows are parser errors.
+template <typename Duration>
+[[nodiscard]] Duration parse_duration(const std::string_view str)
+{
+	using rep = typename Duration::rep;
+	using period = typename Duration::period;
+
+	auto rest = trim_spaces(str);
+	auto is_negative = false;
+	if constexpr (std::is_signed_v<rep>) {
+		if (!rest.empty() && rest.front() == '-') {
+			rest.remove_prefix(1);
+			is_negative = true;
+		}
+	}
+	if (rest == "0") {
+		return Duration::zero();
+	}
+	if (rest.empty()) {
+		throw parser_error{fmt::format("Failed to parse '{}' as duration", str)};
+	}
+
+	auto total = rep{0};
+	while (!rest.empty()) {
+		const auto [number, suffix] = split_number_with_unit(rest, str);
+		const auto* const u = find_unit(duration_units, suffix);
+		if (u == nullptr) {
+			throw parser_error{unknown_unit_message(duration_units, suffix, str)};
+		}
+
+		// Ratio of the unit to the period of the duration, reduced first to keep the factors small.
+		const auto num_gcd = std::gcd(u->num, static_cast<std::uint64_t>(period::num));
+		const auto den_gcd = std::gcd(u->den, static_cast<std::uint64_t>(period::den));
+		auto num = std::uint64_t{};
+		auto den = std::uint64_t{};
+		if (multiply_overflows(u->num / num_gcd, static_cast<std::uint64_t>(period::den) / den_gcd, num)
+		    || multiply_overflows(u->den / den_gcd, static_cast<std::uint64_t>(period::num) / num_gcd, den)) {
+			throw parser_error{fmt::format("Input '{}' is out of range", str)};
+		}
+
+		if constexpr (std::is_floating_point_v<rep>) {
+			total += static_cast<rep>(number) * static_cast<rep>(num) / static_cast<rep>(den);
+		} else {
+			auto scaled = std::uint64_t{};
+			if (multiply_overflows(number, num, scaled)) {
+				throw parser_error{fmt::format("Input '{}' is out of range", str)};
+			}
+			if (scaled % den != 0) {
+				throw parser_error{fmt::format("Input '{}' cannot be represented exactly as duration", str)};
+			}
+			scaled /= den;
+			if (scaled > static_cast<std::uint64_t>(std::numeric_limits<rep>::max() - total)) {
+				throw parser_error{fmt::format("Input '{}' is out of range", str)};
+			}
+			total += static_cast<rep>(scaled);
+		}
+	}
+	return Duration(is_negative ? -total : total);
+}
+
+// Parses byte sizes consisting of a number with an optional unit suffix, e.g. '4096' or '512MiB'.
+[[nodiscard]] inline byte_size parse_byte_size(const std::string_view str)
+{
+	auto rest = trim_spaces(str);
+	const auto [number, suffix] = split_number_with_unit(rest, str);
+	if (!rest.empty()) {
+		throw parser_error{fmt::format("Input '{}' was only parsed partially with remaining data '{}'", str, rest)};
+	}
+	const auto* const u = suffix.empty() ? &byte_size_units[0] : find_unit(byte_size_units, suffix);
+	if (u == nullptr) {
+		throw parser_error{unknown_unit_message(byte_size_units, suffix, str)};
+	}
+	auto count = std::uint64_t{};
+	if (multiply_overflows(number, u->num, count)) {
+		throw parser_error{fmt::format("Input '{}' is out of range", str)};
+	}
+	return byte_size(count);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+// Containers which are parsed from delimited lists of elements.
+template <typename T>
+struct is_delimited_container : std::false_type {
+};
+
+template <typename T, typename Allocator>
+struct is_delimited_container<std::vector<T, Allocator>> : std::true_type {
+};
+
+// Binary data is parsed from its encoding instead.
+template <>
+struct is_delimited_container<bytes> : std::false_type {
+};
+
+template <typename T, typename Compare, typename Allocator>
+struct is_delimited_container<std::set<T, Compare, Allocator>> : std::true_type {
+};
+
+template <typename T, typename Hash, typename KeyEqual, typename Allocator>
+struct is_delimited_container<std::unordered_set<T, Hash, KeyEqual, Allocator>> : std::true_type {
+};
+
+template <typename T, std::size_t N>
+struct is_delimited_container<std::array<T, N>> : std::true_type {
+};
+
+// Sets, which reject duplicate elements just like maps reject duplicate keys.
+template <typename T>
+struct is_delimited_set : std::false_type {
+};
+
+template <typename T, typename Compare, typename Allocator>
+struct is_delimited_set<std::set<T, Compare, Allocator>> : std::true_type {
+};
+
+template <typename T, typename Hash, typename KeyEqual, typename Allocator>
+struct is_delimited_set<std::unordered_set<T, Hash, KeyEqual, Allocator>> : std::true_type {
+};
+
+template <typename T>
+struct is_std_array : std::false_type {
+};
+
+template <typename T, std::size_t N>
+struct is_std_array<std::array<T, N>> : std::true_type {
+};
+
+template <typename T>
+struct is_delimited_pair : std::false_type {
+};
+
+template <typename T1, typename T2>
+struct is_delimited_pair<std::pair<T1, T2>> : std::true_type {
+};
+
+// Maps which are parsed from delimited lists of key-value pairs.
+template <typename T>
+struct is_delimited_map : std::false_type {
+};
+
+template <typename Key, typename T, typename Compare, typename Allocator>
+struct is_delimited_map<std::map<Key, T, Compare, Allocator>> : std::true_type {
+};
+
+template <typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+struct is_delimited_map<std::unordered_map<Key, T, Hash, KeyEqual, Allocator>> : std::true_type {
+};
+
+template <typename Key, typename T, typename Compare>
+struct is_delimited_map<flat_map<Key, T, Compare>> : std::true_type {
+};
+
+template <typename T>
+inline constexpr auto is_delimited_v =
+    is_delimited_container<T>::value || is_delimited_pair<T>::value || is_delimited_map<T>::value;
+
+template <typename T, typename = void>
+struct has_reserve : std::false_type {
+};
+
+template <typename T>
+struct has_reserve<T, std::void_t<decltype(std::declval<T&>().reserve(std::size_t{}))>> : std::true_type {
+};
+
+// Number of delimiters needed to parse 'T', one per level of nesting.
+template <typename T, typename = void>
+struct delimiter_depth : std::integral_constant<std::size_t, 0> {
+};
+
+template <typename T>
+struct delimiter_depth<T, std::enable_if_t<is_delimited_container<T>::value>>
+    : std::integral_constant<std::size_t, 1 + delimiter_depth<typename T::value_type>::value> {
+};
+
+template <typename T>
+struct delimiter_depth<T, std::enable_if_t<is_delimited_pair<T>::value>>
+    : std::integral_constant<std::size_t, 1 + std::max(delimiter_depth<typename T::first_type>::value,
+                                                       delimiter_depth<typename T::second_type>::value)> {
+};
+
+// Maps need one delimiter between entries, and one between the key and value of each entry.
+template <typename T>
+struct delimiter_depth<T, std::enable_if_t<is_delimited_map<T>::value>>
+    : std::integral_constant<std::size_t, 2 + std::max(delimiter_depth<typename T::key_type>::value,
+                                                       delimiter_depth<typename T::mapped_type>::value)> {
+};
+
+template <typename T>
+inline constexpr auto delimiter_depth_v = delimiter_depth<T>::value;
+
+// Delimiters available by default. The elements of vectors, sets, arrays, and the entries of maps are separated by ',',
+// the elements of pairs by ':', and keys and values of map entries by '=', e.g. 'a:1,b:2' for a vector of pairs and
+// 'a=1,b=2' for a map. Nested levels which would reuse a delimiter get the next unused one.
+inline constexpr auto default_delimiter_set = std::string_view(",:;|=");
+
+enum class delimited_kind {
+	none,
+	container,
+	pair,
+	map_entry,
+};
+
+template <typename T, std::size_t N>
+constexpr void get_delimited_kinds(std::array<delimited_kind, N>& kinds, const std::size_t level)
+{
+	if constexpr (is_delimited_container<T>::value) {
+		if (kinds[level] == delimited_kind::none) {
+			kinds[level] = delimited_kind::container;
+		}
+		get_delimited_kinds<typename T::value_type>(kinds, level + 1);
+	} else if constexpr (is_delimited_pair<T>::value) {
+		if (kinds[level] == delimited_kind::none) {
+			kinds[level] = delimited_kind::pair;
+		}
+		get_delimited_kinds<typename T::first_type>(kinds, level + 1);
+		get_delimited_kinds<typename T::second_type>(kinds, level + 1);
+	} else if constexpr (is_delimited_map<T>::value) {
+		if (kinds[level] == delimited_kind::none) {
+			kinds[level] = delimited_kind::container;
+		}
+		if (kinds[level + 1] == delimited_kind::none) {
+			kinds[level + 1] = delimited_kind::map_entry;
+		}
+		get_delimited_kinds<typename T::key_type>(kinds, level + 2);
+		get_delimited_kinds<typename T::mapped_type>(kinds, level + 2);
+	}
+}
+
+// Default delimiters of 'T' from the outermost to the innermost level of nesting, or '\0' if there are not enough.
+template <typename T>
+[[nodiscard]] constexpr auto get_default_delimiters()
+{
+	auto kinds = std::array<delimited_kind, delimiter_depth_v<T>>{};
+	get_delimited_kinds<T>(kinds, 0);
+	auto delimiters = std::array<char, delimiter_depth_v<T>>{};
+	for (std::size_t level = 0; level < kinds.size(); ++level) {
+		const auto is_used = [&](const char delimiter) {
+			for (std::size_t i = 0; i < level; ++i) {
+				if (delimiters[i] == delimiter) {
+					return true;
+				}
+			}
+			return false;
+		};
+		const auto preferred = kinds[level] == delimited_kind::pair        ? ':'
+		                       : kinds[level] == delimited_kind::map_entry ? '='
+		                                                                   : ',';
+		if (!is_used(preferred)) {
+			delimiters[level] = preferred;
+			continue;
+		}
+		for (const auto delimiter : default_delimiter_set) {
+			if (!is_used(delimiter)) {
+				delimiters[level] = delimiter;
+				break;
+			}
+		}
+	}
+	return delimiters;
+}
+
+template <typename T>
+inline constexpr auto default_delimiter_array_v = get_default_delimiters<T>();
+
+template <typename T>
+inline constexpr auto default_delimiters_v =
+    std::string_view(default_delimiter_array_v<T>.data(), default_delimiter_array_v<T>.size());
+
+// Invokes 'fn' with each slice of 'str' between occurrences of 'delimiter', which are searched for with memchr, as it
+// is vectorized by common standard libraries.
+template <typename Fn>
+void split(std::string_view str, const char delimiter, Fn&& fn)
+{
+	while (true) {
+		const auto* const found = static_cast<const char*>(std::memchr(str.data(), delimiter, str.size()));
+		if (found == nullptr) {
+			fn(str);
+			return;
+		}
+		const auto pos = static_cast<std::size_t>(found - str.data());
+		fn(str.substr(0, pos));
+		str.remove_prefix(pos + 1);
+	}
+}
+
+// Invokes 'fn', adding the index of the element to the message of parser and validation errors.
+template <typename Fn>
+[[nodiscard]] auto with_element_index(const std::size_t idx, const std::string_view element, Fn&& fn)
+{
+	try {
+		return fn();
+	} catch (const parser_error& e) {
+		throw parser_error{fmt::format("Element {} '{}': {}", idx, element, e.what())};
+	} catch (const validation_error& e) {
+		throw validation_error{fmt::format("Element {} '{}': {}", idx, element, e.what())};
+	}
+}
+
+template <typename T>
+[[nodiscard]] T parse_delimited(std::string_view str, std::string_view delimiters);
+
+template <typename T>
+[[nodiscard]] T parse_delimited_element(const std::string_view str, const std::string_view delimiters)
+{
+	static_assert(!is_borrowed_string_v<T>, "Elements must not be of borrowed string types, use std::string instead");
+	if constexpr (is_delimited_v<T>) {
+		auto value = parse_delimited<T>(str, delimiters);
+		default_validator<T>{}(value);
+		return value;
+	} else {
+		auto value = default_parser<T>{}(str);
+		default_validator<T>{}(value);
+		return value;
+	}
+}
+
+// Parses 'str' as two elements separated by the first occurrence of 'delimiter'.
+template <typename First, typename Second>
+[[nodiscard]] std::pair<First, Second> parse_delimited_pair(const std::string_view str, const char delimiter,
+                                                            const std::string_view element_delimiters)
+{
+	const auto pos = str.find(delimiter);
+	if (pos == std::string_view::npos) {
+		throw parser_error{fmt::format("Expected two elements separated by '{}' in '{}'", delimiter, str)};
+	}
+	const auto first = str.substr(0, pos);
+	const auto second = str.substr(pos + 1);
+	auto first_value =
+	    with_element_index(0, first, [&] { return parse_delimited_element<First>(first, element_delimiters); });
+	auto second_value =
+	    with_element_index(1, second, [&] { return parse_delimited_element<Second>(second, element_delimiters); });
+	return {std::move(first_value), std::move(second_value)};
+}
+
+// Parses 'str' as a list of elements separated by the first of 'delimiters', where nested elements are separated by the
+// remaining delimiters. An empty string is an empty list. Pairs, including the entries of maps, are split at their
+// first delimiter only. The string is split in a single pass, after counting the delimiters to reserve storage.
+template <typename T>
+[[nodiscard]] T parse_delimited(const std::string_view str, const std::string_view delimiters)
+{
+	const auto delimiter = delimiters.front();
+	const auto element_delimiters = delimiters.substr(1);
+	if constexpr (is_delimited_pair<T>::value) {
+		auto [first, second] =
+		    parse_delimited_pair<std::remove_cv_t<typename T::first_type>, std::remove_cv_t<typename T::second_type>>(
+		        str, delimiter, element_delimiters);
+		return T(std::move(first), std::move(second));
 	} else {
-		throw parser_error{fmt::format("Failed to parse '{}' as boolean", str)};
+		auto value = T{};
+		const auto size =
+		    str.empty() ? std::size_t{0} : static_cast<std::size_t>(std::count(str.begin(), str.end(), delimiter)) + 1;
+		if constexpr (is_std_array<T>::value) {
+			if (size != value.size()) {
+				throw parser_error{fmt::format("Expected {} elements, but got {} in '{}'", value.size(), size, str)};
+			}
+		} else if constexpr (has_reserve<T>::value) {
+			value.reserve(size);
+		}
+		if (size == 0) {
+			return value;
+		}
+		auto idx = std::size_t{0};
+		split(str, delimiter, [&](const std::string_view element) {
+			if constexpr (is_delimited_map<T>::value) {
+				using key_type = std::remove_cv_t<typename T::key_type>;
+				using mapped_type = std::remove_cv_t<typename T::mapped_type>;
+				const auto entry_delimiter = element_delimiters.front();
+				auto [key, mapped] = with_element_index(idx, element, [&] {
+					return parse_delimited_pair<key_type, mapped_type>(element, entry_delimiter,
+					                                                   element_delimiters.substr(1));
+				});
+				if (!value.emplace(std::move(key), std::move(mapped)).second) {
+					throw parser_error{fmt::format("Element {} '{}': Duplicate key '{}'", idx, element,
+					                               element.substr(0, element.find(entry_delimiter)))};
+				}
+			} else {
+				using element_type = typename T::value_type;
+				auto element_value = with_element_index(
+				    idx, element, [&] { return parse_delimited_element<element_type>(element, element_delimiters); });
+				if constexpr (is_std_array<T>::value) {
+					value[idx] = std::move(element_value);
+				} else if constexpr (is_delimited_set<T>::value) {
+					if (!value.insert(std::move(element_value)).second) {
+						throw parser_error{fmt::format("Element {} '{}': Duplicate element", idx, element)};
+					}
+				} else {
+					value.insert(value.end(), std::move(element_value));
+				}
+			}
+			++idx;
+		});
+		return value;
 	}
 }
 
 template <typename T>
 [[nodiscard]] T construct_from_string(const std::string_view str)
 {
-	if constexpr (is_string_constructible_v<T>) {
+	if constexpr (is_borrowed_string_v<T>) {
+		return T(str.data(), str.size());
+	} else if constexpr (std::is_same_v<T, bytes>) {
+		return decode_bytes(trim_spaces(str), bytes_encoding::base64);
+	} else if constexpr (is_delimited_v<T>) {
+		static_assert(delimiter_depth_v<T> <= default_delimiter_set.size(),
+		              "Type is nested too deeply to be parsed with the default delimiters");
+		return parse_delimited<T>(str, default_delimiters_v<T>);
+	} else if constexpr (is_duration<T>::value) {
+		return parse_duration<T>(str);
+	} else if constexpr (std::is_same_v<T, byte_size>) {
+		return parse_byte_size(str);
+	} else if constexpr (is_string_constructible_v<T>) {
 		try {
-			return T(std::string(str));
+			if constexpr (std::is_constructible_v<T, std::string_view>) {
+				return T(str);
+			} else {
+				return T(std::string(str));
+			}
 		} catch (const parser_error&) {
 			throw;
 		} catch (const std::exception& e) {
@@ -96,49 +886,47 @@ template <typename T>
 		} catch (...) {
 			throw parser_error{fmt::format("String constructor failed for input '{}' with unknown error", str)};
 		}
+	} else if constexpr (std::is_same_v<T, bool>) {
+		return parse_bool(str);
+	} else if constexpr (is_from_chars_parsable_v<T>) {
+		return parse_arithmetic<T>(str);
 	} else if constexpr (is_stringstream_constructible_v<T>) {
-		auto stream = std::istringstream(std::string(str));
-		auto parsed = T();
-		try {
-			if constexpr (std::is_same_v<T, bool>) {
-				stream >> parsed;
-				if (stream.fail()) {
-					stream = std::istringstream(std::string(str));
-					std::string bool_str;
-					stream >> bool_str;
-					parsed = parse_bool(bool_str);
+		auto parsed = with_input_stream(str, [&](std::istringstream& stream) {
+			auto value = T();
+			try {
+				stream >> value;
+				if (!stream.eof()) {
+					stream >> std::ws;
 				}
-			} else {
-				stream >> parsed;
+			} catch (const parser_error&) {
+				throw;
+			} catch (const std::exception& e) {
+				throw parser_error{fmt::format("Stream operator>> failed for input '{}' with '{}'", str, e.what())};
+			} catch (...) {
+				throw parser_error{fmt::format("Stream operator>> failed for input '{}' with unknown error", str)};
 			}
-			if (!stream.eof()) {
-				stream >> std::ws;
+			if (stream.fail()) {
+				throw parser_error{fmt::format("Stream operator>> failed for input '{}'", str)};
 			}
-		} catch (const parser_error&) {
-			throw;
-		} catch (const std::exception& e) {
-			throw parser_error{fmt::format("Stream operator>> failed for input '{}' with '{}'", str, e.what())};
-		} catch (...) {
-			throw parser_error{fmt::format("Stream operator>> failed for input '{}' with unknown error", str)};
-		}
-		if (stream.fail()) {
-			throw parser_error{fmt::format("Stream operator>> failed for input '{}'", str)};
-		}
-		if (static_cast<std::size_t>(stream.tellg()) < str.size()) {
-			throw parser_error{fmt::format("Input '{}' was only parsed partially with remaining data '{}'", str,
-			                               stream.str().substr(stream.tellg()))};
-		}
-		if constexpr (!std::is_same_v<T, bool> && std::is_unsigned_v<T>) {
-			auto signed_parsed = std::int64_t{};
-			auto signed_stream = std::istringstream(std::string(str));
-			signed_stream >> signed_parsed;
-			if (!signed_stream.eof()) {
-				signed_stream >> std::ws;
-			}
-			if (signed_stream.fail() || static_cast<std::size_t>(signed_stream.tellg()) < str.size()) {
-				throw parser_error{
-				    fmt::format("Failed to validate whether '{}' was correctly parsed as '{}'", str, parsed)};
+			if (static_cast<std::size_t>(stream.tellg()) < str.size()) {
+				throw parser_error{fmt::format("Input '{}' was only parsed partially with remaining data '{}'", str,
+				                               str.substr(static_cast<std::size_t>(stream.tellg())))};
 			}
+			return value;
+		});
+		if constexpr (std::is_unsigned_v<T>) {
+			const auto signed_parsed = with_input_stream(str, [&](std::istringstream& signed_stream) {
+				auto value = std::int64_t{};
+				signed_stream >> value;
+				if (!signed_stream.eof()) {
+					signed_stream >> std::ws;
+				}
+				if (signed_stream.fail() || static_cast<std::size_t>(signed_stream.tellg()) < str.size()) {
+					throw parser_error{
+					    fmt::format("Failed to validate whether '{}' was correctly parsed as '{}'", str, parsed)};
+				}
+				return value;
+			});
 			if (signed_parsed < 0) {
 				throw parser_error{fmt::format("Cannot parse negative number '{}' as unsigned type", str)};
 			}
@@ -166,42 +954,107 @@ template <typename T>
 struct default_parser_and_validator {
 	[[nodiscard]] T operator()(const std::string_view str) const
 	{
-		const auto value = default_parser<T>{}(str);
+		auto value = default_parser<T>{}(str);
 		default_validator<T>{}(value);
 		return value;
 	}
 };
 
-namespace detail {
+// Parser and validator for delimited containers, i.e. vectors, sets, arrays, pairs, and maps, with custom delimiters,
+// which are given from the outermost to the innermost level of nesting. Each element is parsed with 'default_parser'
+// and validated with 'default_validator'.
+template <typename T>
+class delimited_parser_and_validator {
+	static_assert(detail::is_delimited_v<T>, "Type must be a vector, set, array, pair, or map");
 
-template <typename T, typename ParserAndValidator>
-[[nodiscard]] expected<T, std::string> parse_or_error(const std::string_view env_var_name,
-                                                      const std::string_view env_var_value,
-                                                      ParserAndValidator&& parser_and_validator)
-{
-	using expected_t = expected<T, std::string>;
-	using unexpected_t = typename expected_t::unexpected_type;
+  public:
+	explicit delimited_parser_and_validator(const char delimiter)
+	    : delimited_parser_and_validator(std::string(1, delimiter))
+	{
+	}
+
+	explicit delimited_parser_and_validator(std::string delimiters) : m_delimiters(std::move(delimiters))
+	{
+		if (m_delimiters.size() < detail::delimiter_depth_v<T>) {
+			throw invalid_delimiters{fmt::format("Expected {} delimiters, but got {} in '{}'",
+			                                     detail::delimiter_depth_v<T>, m_delimiters.size(), m_delimiters)};
+		}
+		auto sorted = m_delimiters;
+		std::sort(sorted.begin(), sorted.end());
+		if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+			throw invalid_delimiters{fmt::format("Duplicate delimiter in '{}'", m_delimiters)};
+		}
+	}
 
-	auto error_msg = typename expected_t::error_type();
+	[[nodiscard]] T operator()(const std::string_view str) const
+	{
+		auto value = detail::parse_delimited<T>(str, m_delimiters);
+		default_validator<T>{}(value);
+		return value;
+	}
+
+  private:
+	std::string m_delimiters;
+};
 
+// Parser and validator for binary data in the given encoding, whereas 'default_parser' expects base64.
+class bytes_parser_and_validator {
+  public:
+	explicit bytes_parser_and_validator(const bytes_encoding encoding) noexcept : m_encoding(encoding) {}
+
+	[[nodiscard]] bytes operator()(const std::string_view str) const
+	{
+		auto value = detail::decode_bytes(detail::trim_spaces(str), m_encoding);
+		default_validator<bytes>{}(value);
+		return value;
+	}
+
+  private:
+	bytes_encoding m_encoding;
+};
+
+namespace detail {
+
+// Invokes 'parse_and_validate(env_var_value)', returning the error message if it throws.
+template <typename ParseAndValidateFn>
+[[nodiscard]] std::optional<std::string> get_parse_and_validate_error(const std::string_view env_var_name,
+                                                                      const std::string_view env_var_value,
+                                                                      ParseAndValidateFn&& parse_and_validate)
+{
 	try {
-		return expected_t{parser_and_validator(env_var_value)};
+		parse_and_validate(env_var_value);
+		return std::nullopt;
 	} catch (const parser_error& e) {
-		error_msg = fmt::format("Parser error for environment variable '{}': {}", env_var_name, e.what());
+		return fmt::format("Parser error for environment variable '{}': {}", env_var_name, e.what());
 	} catch (const validation_error& e) {
-		error_msg = fmt::format("Validation error for environment variable '{}': {}", env_var_name, e.what());
+		return fmt::format("Validation error for environment variable '{}': {}", env_var_name, e.what());
 	} catch (const range_error& e) {
-		error_msg = fmt::format("Range error for environment variable '{}': {}", env_var_name, e.what());
+		return fmt::format("Range error for environment variable '{}': {}", env_var_name, e.what());
 	} catch (const option_error& e) {
-		error_msg = fmt::format("Option error for environment variable '{}': {}", env_var_name, e.what());
+		return fmt::format("Option error for environment variable '{}': {}", env_var_name, e.what());
 	} catch (const std::exception& e) {
-		error_msg =
-		    fmt::format("Failed to parse or validate environment variable '{}' with: {}", env_var_name, e.what());
+		return fmt::format("Failed to parse or validate environment variable '{}' with: {}", env_var_name, e.what());
 	} catch (...) {
-		error_msg =
-		    fmt::format("Failed to parse or validate environment variable '{}' with unknown error", env_var_name);
+		return fmt::format("Failed to parse or validate environment variable '{}' with unknown error", env_var_name);
+	}
+}
+
+template <typename T, typename ParserAndValidator>
+[[nodiscard]] expected<T, std::string> parse_or_error(const std::string_view env_var_name,
+                                                      const std::string_view env_var_value,
+                                                      ParserAndValidator&& parser_and_validator)
+{
+	using expected_t = expected<T, std::string>;
+	using unexpected_t = typename expected_t::unexpected_type;
+
+	auto value = std::optional<T>{};
+	auto error_msg = get_parse_and_validate_error(env_var_name, env_var_value, [&](const std::string_view str) {
+		value.emplace(parser_and_validator(str));
+	});
+	if (error_msg.has_value()) {
+		return expected_t{unexpected_t{std::move(*error_msg)}};
 	}
-	return expected_t{unexpected_t{error_msg}};
+	return expected_t{std::move(*value)};
 }
 
 } // namespace detail
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace env::detail {
+
+// Move-only type-erased parser and validator, which constructs the parsed value of type 'T' in place. Callables are
+// invoked through a static table of function pointers per callable type. They are stored inline if they fit into a
+// small buffer, which is large enough for all callables created by the library, so that creating, moving, and invoking
+// them does not allocate. Larger callables are stored on the heap.
+class parser_and_validator_fn {
+	static constexpr auto inline_storage_size = 6 * sizeof(void*);
+	static constexpr auto inline_storage_alignment = alignof(std::max_align_t);
+
+	struct vtable {
+		void (*invoke)(void* storage, const std::string_view str, void* value);
+		// Move constructs the callable into 'dst' and destroys the one in 'src'.
+		void (*relocate)(void* dst, void* src) noexcept;
+		void (*destroy)(void* storage) noexcept;
+	};
+
+	template <typename T, typename Fn>
+	struct callable {
+		[[nodiscard]] static Fn& get(void* storage) noexcept
+		{
+			if constexpr (is_stored_inline<Fn>) {
+				return *std::launder(static_cast<Fn*>(storage));
+			} else {
+				return **static_cast<Fn**>(storage);
+			}
+		}
+
+		static void invoke(void* storage, const std::string_view str, void* value)
+		{
+			if constexpr (std::is_void_v<T>) {
+				get(storage)(str);
+			} else {
+				static_assert(std::is_convertible_v<decltype(get(storage)(str)), T>,
+				              "Parser and validator function must return type convertible to T");
+				::new (value) T(get(storage)(str));
+			}
+		}
+
+		static void relocate(void* dst, void* src) noexcept
+		{
+			if constexpr (is_stored_inline<Fn>) {
+				::new (dst) Fn(std::move(get(src)));
+				get(src).~Fn();
+			} else {
+				*static_cast<Fn**>(dst) = *static_cast<Fn**>(src);
+			}
+		}
+
+		static void destroy(void* storage) noexcept
+		{
+			if constexpr (is_stored_inline<Fn>) {
+				get(storage).~Fn();
+			} else {
+				delete *static_cast<Fn**>(storage);
+			}
+		}
+
+		static constexpr auto table = vtable{&invoke, &relocate, &destroy};
+	};
+
+  public:
+	template <typename Fn>
+	static constexpr auto is_stored_inline = sizeof(Fn) <= inline_storage_size
+	                                         && alignof(Fn) <= inline_storage_alignment
+	                                         && std::is_nothrow_move_constructible_v<Fn>;
+
+	parser_and_validator_fn() = default;
+
+	template <typename T, typename Fn>
+	parser_and_validator_fn(std::in_place_type_t<T>, Fn&& fn)
+	{
+		using fn_t = std::decay_t<Fn>;
+		if constexpr (is_stored_inline<fn_t>) {
+			::new (static_cast<void*>(&m_storage)) fn_t(std::forward<Fn>(fn));
+		} else {
+			*reinterpret_cast<fn_t**>(&m_storage) = new fn_t(std::forward<Fn>(fn));
+		}
+		m_vtable = &callable<T, fn_t>::table;
+	}
+
+	parser_and_validator_fn(const parser_and_validator_fn&) = delete;
+	parser_and_validator_fn(parser_and_validator_fn&& other) noexcept { *this = std::move(other); }
+
+	parser_and_validator_fn& operator=(const parser_and_validator_fn&) = delete;
+	parser_and_validator_fn& operator=(parser_and_validator_fn&& other) noexcept
+	{
+		if (this != &other) {
+			reset();
+			if (other.m_vtable != nullptr) {
+				other.m_vtable->relocate(&m_storage, &other.m_storage);
+				m_vtable = std::exchange(other.m_vtable, nullptr);
+			}
+		}
+		return *this;
+	}
+
+	~parser_and_validator_fn() { reset(); }
+
+	// Parses and validates 'str', and constructs the resulting value at 'value', which must be suitable storage for a
+	// 'T'. If 'T' is void, nothing is constructed.
+	void operator()(const std::string_view str, void* value) { m_vtable->invoke(&m_storage, str, value); }
+
+	[[nodiscard]] explicit operator bool() const noexcept { return m_vtable != nullptr; }
+
+  private:
+	void reset() noexcept
+	{
+		if (m_vtable != nullptr) {
+			m_vtable->destroy(&m_storage);
+			m_vtable = nullptr;
+		}
+	}
+
+	const vtable* m_vtable = nullptr;
+	alignas(inline_storage_alignment) std::byte m_storage[inline_storage_size];
+};
+
+} // namespace env::detail
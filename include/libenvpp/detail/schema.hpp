@@ -0,0 +1,344 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <libenvpp/detail/edit_distance.hpp>
+#include <libenvpp/detail/environment.hpp>
+#include <libenvpp/detail/errors.hpp>
+#include <libenvpp/detail/parser.hpp>
+#include <libenvpp/detail/testing.hpp>
+
+namespace env {
+
+// Constraints of schema variables, see 'schema_variable'.
+struct required {
+};
+
+template <auto Min, auto Max>
+struct range {
+	static_assert(!(Max < Min), "Invalid range, min must be less or equal to max");
+};
+
+template <auto... Options>
+struct options {
+	static_assert(sizeof...(Options) > 0, "No options provided");
+};
+
+namespace detail {
+
+template <typename T>
+struct member_pointer_traits;
+
+template <typename Class, typename Value>
+struct member_pointer_traits<Value Class::*> {
+	using class_type = Class;
+	using value_type = Value;
+};
+
+template <typename T>
+struct optional_value {
+	using type = T;
+};
+
+template <typename T>
+struct optional_value<std::optional<T>> {
+	using type = T;
+};
+
+// 64-bit FNV-1a, which unlike 'std::hash' can be evaluated at compile time.
+[[nodiscard]] constexpr std::uint64_t fnv1a_hash(const std::string_view str,
+                                                 std::uint64_t hash = 14695981039346656037ull) noexcept
+{
+	for (const auto c : str) {
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+[[nodiscard]] constexpr bool is_valid_env_var_name(const std::string_view name) noexcept
+{
+	for (const auto c : name) {
+		if (c == '=' || c == '\0') {
+			return false;
+		}
+	}
+	return !name.empty();
+}
+
+template <typename T>
+void check_constraint(const T&, const std::string_view, required)
+{
+}
+
+template <typename T, auto Min, auto Max>
+void check_constraint(const T& value, const std::string_view, range<Min, Max>)
+{
+	// Braced initialization diagnoses bounds which are not representable by 'T' at compile time.
+	constexpr auto min = T{Min};
+	constexpr auto max = T{Max};
+	if (value < min || value > max) {
+		throw range_error{fmt::format("Value {} outside of range [{}, {}]", value, min, max)};
+	}
+}
+
+template <typename T, auto... Options>
+void check_constraint(const T& value, const std::string_view str, options<Options...>)
+{
+	if (((value != T{Options}) && ...)) {
+		throw option_error{fmt::format("Unrecognized option '{}'", str)};
+	}
+}
+
+} // namespace detail
+
+// Variable of a 'schema', which is parsed into the member 'Member' of the schema's struct. Constraints are given as
+// types, i.e. 'required', 'range<Min, Max>', and 'options<Options...>', e.g.
+// 'schema_variable<&config::num_threads, required, range<1, 64>>("NUM_THREADS")'. Members of optional variables which
+// are not set keep their default value, so defaults are given by default member initializers of the struct. Members
+// of type 'std::optional<T>' are parsed as 'T'.
+template <auto Member, typename... Constraints>
+class schema_variable {
+	using member_traits = detail::member_pointer_traits<decltype(Member)>;
+
+  public:
+	using config_type = typename member_traits::class_type;
+	using value_type = typename detail::optional_value<typename member_traits::value_type>::type;
+
+	static constexpr auto is_required = (std::is_same_v<Constraints, required> || ...);
+
+	static_assert(!detail::is_borrowed_string_v<value_type>,
+	              "Borrowed string types are not supported for schema variables, as nothing keeps their data alive");
+
+	constexpr explicit schema_variable(const std::string_view name) : m_name(name) {}
+
+	[[nodiscard]] constexpr std::string_view name() const noexcept { return m_name; }
+
+	static void parse_into(config_type& config, const std::string_view str)
+	{
+		auto value = default_parser_and_validator<value_type>{}(str);
+		(detail::check_constraint(value, str, Constraints{}), ...);
+		config.*Member = std::move(value);
+	}
+
+  private:
+	std::string_view m_name;
+};
+
+template <typename Config>
+class parsed_and_validated_schema {
+  public:
+	// The struct with all successfully parsed and validated variables.
+	[[nodiscard]] const Config& values() const& noexcept { return m_values; }
+	[[nodiscard]] Config values() && noexcept { return std::move(m_values); }
+
+	[[nodiscard]] bool ok() const noexcept { return m_errors.empty() && m_warnings.empty(); }
+
+	[[nodiscard]] std::string error_message() const { return detail::format_messages("Error", m_errors); }
+
+	[[nodiscard]] std::string warning_message() const { return detail::format_messages("Warning", m_warnings); }
+
+	[[nodiscard]] const std::vector<error>& errors() const noexcept { return m_errors; }
+
+	[[nodiscard]] const std::vector<error>& warnings() const noexcept { return m_warnings; }
+
+  private:
+	parsed_and_validated_schema(Config values, std::vector<error> errors, std::vector<error> warnings)
+	    : m_values(std::move(values)), m_errors(std::move(errors)), m_warnings(std::move(warnings))
+	{
+	}
+
+	Config m_values;
+	std::vector<error> m_errors;
+	std::vector<error> m_warnings;
+
+	template <typename... Variables>
+	friend class schema;
+};
+
+// Compile-time alternative to 'prefix' for static configurations, which parses the variables directly into the members
+// of a caller-defined struct, e.g.
+//
+//     constexpr auto config_schema = env::schema("MYPROG", env::schema_variable<&config::log_path>("LOG_PATH"),
+//                                                env::schema_variable<&config::num_threads, env::required>("THREADS"));
+//
+// Invalid and duplicate names throw, which is diagnosed at compile time if the schema is declared 'constexpr'. The
+// full names of all variables are hashed at compile time, so parsing and validating matches the environment against
+// them in a single pass. The errors and warnings are the same as for a prefix with the same variables, with the
+// variables' ids being their position in the schema.
+template <typename... Variables>
+class schema {
+	static_assert(sizeof...(Variables) > 0, "A schema must have at least one variable");
+
+	static constexpr auto num_variables = sizeof...(Variables);
+
+  public:
+	using config_type = typename std::tuple_element_t<0, std::tuple<Variables...>>::config_type;
+
+	static_assert((std::is_same_v<typename Variables::config_type, config_type> && ...),
+	              "All variables of a schema must be members of the same struct");
+	static_assert(std::is_default_constructible_v<config_type>, "The struct of a schema must be default constructible");
+
+	constexpr schema(const std::string_view prefix_name, const Variables... variables)
+	    : m_prefix_name(prefix_name), m_names{variables.name()...}, m_hashes{}
+	{
+		if (prefix_name.empty()) {
+			throw invalid_prefix{"Prefix name must not be empty"};
+		}
+		if (!detail::is_valid_env_var_name(prefix_name)) {
+			throw invalid_prefix{"Prefix name must not contain '=' or null characters"};
+		}
+		const auto prefix_hash = detail::fnv1a_hash(PREFIX_DELIMITER, detail::fnv1a_hash(prefix_name));
+		for (std::size_t i = 0; i < num_variables; ++i) {
+			if (!detail::is_valid_env_var_name(m_names[i])) {
+				throw invalid_variable_name{"Variable name must not be empty or contain '=' or null characters"};
+			}
+			for (std::size_t j = 0; j < i; ++j) {
+				if (m_names[j] == m_names[i]) {
+					throw duplicate_variable{"Variable name must be unique within a schema"};
+				}
+			}
+			m_hashes[i] = detail::fnv1a_hash(m_names[i], prefix_hash);
+		}
+	}
+
+	// Parses and validates the system environment, with the testing environment layered on top of it.
+	[[nodiscard]] parsed_and_validated_schema<config_type> parse_and_validate() const
+	{
+		const auto system_environment = detail::get_environment_snapshot();
+		return parse_and_validate(*system_environment);
+	}
+
+	// Parses and validates a custom environment, which can be of any type supported by 'environment_source', with the
+	// testing environment layered on top of it.
+	template <typename Environment>
+	[[nodiscard]] parsed_and_validated_schema<config_type>
+	parse_and_validate(const Environment& system_environment) const
+	{
+		auto environment = detail::layered_environment<Environment>(detail::g_testing_environment, system_environment);
+
+		auto config = config_type{};
+		auto errors = std::vector<error>{};
+		auto warnings = std::vector<error>{};
+		auto is_set = std::array<bool, num_variables>{};
+		auto unused_env_vars = std::vector<std::string_view>{};
+
+		environment.for_each([&](const std::string_view name, const std::string_view value) {
+			if (!has_prefix(name)) {
+				return;
+			}
+			const auto id = find_variable(name);
+			if (id == num_variables) {
+				unused_env_vars.push_back(name);
+				return;
+			}
+			is_set[id] = true;
+			auto error_msg = detail::get_parse_and_validate_error(
+			    name, value, [&](const std::string_view str) { parse_into_fns[id](config, str); });
+			if (error_msg.has_value()) {
+				errors.emplace_back(id, m_names[id], std::move(*error_msg));
+			}
+		});
+		// The environment is iterated in arbitrary order, errors are reported in the order of the variables instead.
+		std::stable_sort(errors.begin(), errors.end(),
+		                 [](const error& lhs, const error& rhs) { return lhs.get_id() < rhs.get_id(); });
+
+		if (std::find(is_set.begin(), is_set.end(), false) != is_set.end()) {
+			for (std::size_t id = 0; id < num_variables; ++id) {
+				if (is_set[id]) {
+					environment.consume(get_full_name(id));
+				}
+			}
+			for (std::size_t id = 0; id < num_variables; ++id) {
+				if (is_set[id]) {
+					continue;
+				}
+				const auto var_name = get_full_name(id);
+				const auto edit_distance_cutoff = default_edit_distance.get_or_default(var_name.length());
+				const auto similar_env_var = detail::find_similar_env_var(var_name, environment, edit_distance_cutoff);
+				if (similar_env_var.has_value()) {
+					environment.consume(*similar_env_var);
+					unused_env_vars.erase(
+					    std::remove(unused_env_vars.begin(), unused_env_vars.end(), *similar_env_var),
+					    unused_env_vars.end());
+					auto similar_env_var_error = detail::get_similar_env_var_error(id, var_name, *similar_env_var);
+					if (is_required[id]) {
+						errors.push_back(std::move(similar_env_var_error));
+					} else {
+						warnings.push_back(std::move(similar_env_var_error));
+					}
+				} else if (is_required[id]) {
+					errors.push_back(detail::get_unset_env_var_error(id, var_name));
+				}
+			}
+		}
+
+		for (const auto unused_var : unused_env_vars) {
+			warnings.emplace_back(-1, unused_var,
+			                      fmt::format("Prefix environment variable '{}' specified but unused", unused_var));
+		}
+
+		return {std::move(config), std::move(errors), std::move(warnings)};
+	}
+
+	[[nodiscard]] std::string help_message() const
+	{
+		auto msg = fmt::format("Prefix '{}{}' supports the following {} environment variable(s):\n", m_prefix_name,
+		                       PREFIX_DELIMITER, num_variables);
+		for (std::size_t id = 0; id < num_variables; ++id) {
+			msg += fmt::format("\t'{}' {}\n", get_full_name(id), is_required[id] ? "required" : "optional");
+		}
+		return msg;
+	}
+
+  private:
+	static constexpr auto PREFIX_DELIMITER = std::string_view("_");
+
+	using parse_into_fn = void (*)(config_type&, std::string_view);
+	static constexpr auto parse_into_fns = std::array<parse_into_fn, num_variables>{&Variables::parse_into...};
+	static constexpr auto is_required = std::array<bool, num_variables>{Variables::is_required...};
+
+	[[nodiscard]] bool has_prefix(const std::string_view name) const noexcept
+	{
+		return name.size() >= m_prefix_name.size() + PREFIX_DELIMITER.size()
+		       && name.substr(0, m_prefix_name.size()) == m_prefix_name
+		       && name.substr(m_prefix_name.size(), PREFIX_DELIMITER.size()) == PREFIX_DELIMITER;
+	}
+
+	// Returns the id of the variable with the full name 'name', which must start with the prefix, or the number of
+	// variables if there is none.
+	[[nodiscard]] std::size_t find_variable(const std::string_view name) const noexcept
+	{
+		const auto hash = detail::fnv1a_hash(name);
+		const auto var_name = name.substr(m_prefix_name.size() + PREFIX_DELIMITER.size());
+		for (std::size_t id = 0; id < num_variables; ++id) {
+			if (m_hashes[id] == hash && m_names[id] == var_name) {
+				return id;
+			}
+		}
+		return num_variables;
+	}
+
+	[[nodiscard]] std::string get_full_name(const std::size_t id) const
+	{
+		return fmt::format("{}{}{}", m_prefix_name, PREFIX_DELIMITER, m_names[id]);
+	}
+
+	std::string_view m_prefix_name;
+	std::array<std::string_view, num_variables> m_names;
+	std::array<std::uint64_t, num_variables> m_hashes;
+};
+
+} // namespace env
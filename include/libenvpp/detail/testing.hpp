@@ -10,10 +10,6 @@ namespace detail {
 
 extern std::unordered_map<std::string, std::string> g_testing_environment;
 
-[[nodiscard]] std::unordered_map<std::string, std::string>
-merge_environments(const std::unordered_map<std::string, std::string>& high_precedence_env,
-                   const std::unordered_map<std::string, std::string>& low_precedence_env);
-
 } // namespace detail
 
 class [[nodiscard]] scoped_test_environment {
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <libenvpp/detail/check.hpp>
+
+namespace env::detail {
+
+// Size, alignment, and type-erased lifetime operations of a type stored in a 'value_arena'.
+struct value_type_info {
+	std::size_t size;
+	std::size_t alignment;
+	// Move constructs the value at 'dst' from the one at 'src', and destroys the one at 'src'.
+	void (*relocate)(void* dst, void* src);
+	void (*destroy)(void* value) noexcept;
+};
+
+template <typename T>
+inline constexpr auto value_type_info_v = value_type_info{
+    sizeof(T),
+    alignof(T),
+    [](void* dst, void* src) {
+	    auto& src_value = *std::launder(static_cast<T*>(src));
+	    ::new (dst) T(std::move(src_value));
+	    src_value.~T();
+    },
+    [](void* value) noexcept { std::launder(static_cast<T*>(value))->~T(); },
+};
+
+// Storage for the values of all variables of a prefix. The layout is computed while adding slots, i.e. while variables
+// are registered, so that all values are stored at fixed offsets in a single aligned allocation. Whether a slot holds a
+// value is tracked per slot, so only constructed values are destroyed.
+class value_arena {
+	struct slot {
+		const value_type_info* info;
+		std::size_t offset;
+		bool has_value;
+	};
+
+	struct aligned_deleter {
+		std::size_t alignment;
+		void operator()(std::byte* storage) const noexcept { ::operator delete(storage, std::align_val_t{alignment}); }
+	};
+
+	using storage_t = std::unique_ptr<std::byte[], aligned_deleter>;
+
+  public:
+	value_arena() = default;
+
+	value_arena(const value_arena&) = delete;
+	value_arena(value_arena&& other) noexcept { *this = std::move(other); }
+
+	value_arena& operator=(const value_arena&) = delete;
+	value_arena& operator=(value_arena&& other) noexcept
+	{
+		if (this != &other) {
+			reset_all();
+			m_slots = std::exchange(other.m_slots, {});
+			m_storage = std::exchange(other.m_storage, storage_t(nullptr, aligned_deleter{alignof(std::max_align_t)}));
+			m_size = std::exchange(other.m_size, 0);
+			m_capacity = std::exchange(other.m_capacity, 0);
+			m_alignment = std::exchange(other.m_alignment, alignof(std::max_align_t));
+		}
+		return *this;
+	}
+
+	~value_arena() { reset_all(); }
+
+	// Adds a slot for values of the type described by 'info', or a slot which never holds a value if it is nullptr.
+	// Returns the index of the slot.
+	std::size_t add_slot(const value_type_info* info)
+	{
+		auto offset = m_size;
+		if (info != nullptr) {
+			offset = (m_size + info->alignment - 1) / info->alignment * info->alignment;
+			m_size = offset + info->size;
+			m_alignment = std::max(m_alignment, info->alignment);
+		}
+		m_slots.push_back({info, offset, false});
+		return m_slots.size() - 1;
+	}
+
+	// Allocates the storage for all slots, unless it has already been allocated since the last slot was added. Values
+	// which have already been constructed are moved into the new storage.
+	void allocate()
+	{
+		if (m_size <= m_capacity) {
+			return;
+		}
+		auto storage = storage_t(static_cast<std::byte*>(::operator new(m_size, std::align_val_t{m_alignment})),
+		                         aligned_deleter{m_alignment});
+		for (const auto& s : m_slots) {
+			if (s.has_value) {
+				s.info->relocate(storage.get() + s.offset, m_storage.get() + s.offset);
+			}
+		}
+		m_storage = std::move(storage);
+		m_capacity = m_size;
+	}
+
+	[[nodiscard]] bool has_value(const std::size_t slot) const noexcept { return m_slots[slot].has_value; }
+
+	// Whether a slot can hold a value at all, i.e. whether it was added with a value type.
+	[[nodiscard]] bool has_value_type(const std::size_t slot) const noexcept { return m_slots[slot].info != nullptr; }
+
+	// Returns the uninitialized storage of an empty slot, in which a value can be constructed. Requires the storage to
+	// have been allocated.
+	[[nodiscard]] void* get_storage(const std::size_t slot)
+	{
+		LIBENVPP_CHECK(m_size <= m_capacity && !m_slots[slot].has_value);
+		return m_storage.get() + m_slots[slot].offset;
+	}
+
+	// Marks the value of a slot as constructed, after it was constructed in the storage returned by 'get_storage'.
+	void set_constructed(const std::size_t slot)
+	{
+		LIBENVPP_CHECK(m_slots[slot].info != nullptr);
+		m_slots[slot].has_value = true;
+	}
+
+	template <typename T>
+	[[nodiscard]] const T& get(const std::size_t slot) const
+	{
+		LIBENVPP_CHECK(m_slots[slot].has_value);
+		return *std::launder(reinterpret_cast<const T*>(m_storage.get() + m_slots[slot].offset));
+	}
+
+	template <typename T>
+	[[nodiscard]] T& get(const std::size_t slot)
+	{
+		LIBENVPP_CHECK(m_slots[slot].has_value);
+		return *std::launder(reinterpret_cast<T*>(m_storage.get() + m_slots[slot].offset));
+	}
+
+	// Moves the value out of a slot, which no longer holds a value afterwards.
+	template <typename T>
+	[[nodiscard]] T take(const std::size_t slot)
+	{
+		auto value = std::move(get<T>(slot));
+		reset(slot);
+		return value;
+	}
+
+	template <typename T, typename... Args>
+	T& emplace(const std::size_t slot, Args&&... args)
+	{
+		allocate();
+		reset(slot);
+		auto* const value = ::new (get_storage(slot)) T(std::forward<Args>(args)...);
+		set_constructed(slot);
+		return *value;
+	}
+
+	void reset(const std::size_t slot) noexcept
+	{
+		auto& s = m_slots[slot];
+		if (s.has_value) {
+			s.info->destroy(m_storage.get() + s.offset);
+			s.has_value = false;
+		}
+	}
+
+  private:
+	void reset_all() noexcept
+	{
+		for (std::size_t i = 0; i < m_slots.size(); ++i) {
+			reset(i);
+		}
+	}
+
+	std::vector<slot> m_slots;
+	storage_t m_storage = storage_t(nullptr, aligned_deleter{alignof(std::max_align_t)});
+	std::size_t m_size = 0;
+	std::size_t m_capacity = 0;
+	std::size_t m_alignment = alignof(std::max_align_t);
+};
+
+} // namespace env::detail
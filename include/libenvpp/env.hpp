@@ -1,15 +1,15 @@
 #pragma once
 
 #include <algorithm>
-#include <any>
 #include <cstddef>
 #include <functional>
 #include <initializer_list>
+#include <memory>
 #include <optional>
-#include <set>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -20,8 +20,14 @@
 #include <libenvpp/detail/environment.hpp>
 #include <libenvpp/detail/errors.hpp>
 #include <libenvpp/detail/get.hpp>
+#include <libenvpp/detail/name_pool.hpp>
+#include <libenvpp/detail/option_table.hpp>
+#include <libenvpp/detail/option_traits.hpp>
 #include <libenvpp/detail/parser.hpp>
+#include <libenvpp/detail/parser_and_validator_fn.hpp>
+#include <libenvpp/detail/schema.hpp>
 #include <libenvpp/detail/testing.hpp>
+#include <libenvpp/detail/value_arena.hpp>
 
 namespace env {
 
@@ -33,8 +39,6 @@ namespace detail {
 
 class variable_data {
   public:
-	using parser_and_validator_fn = std::function<std::any(const std::string_view)>;
-
 	variable_data() = delete;
 
 	variable_data(const variable_data&) = delete;
@@ -44,15 +48,17 @@ class variable_data {
 	variable_data& operator=(variable_data&&) = default;
 
   private:
-	variable_data(const std::string_view name, bool is_required, parser_and_validator_fn parser_and_validator)
-	    : m_name(name), m_is_required(is_required), m_parser_and_validator(std::move(parser_and_validator))
+	variable_data(bool is_required, parser_and_validator_fn parser_and_validator)
+	    : m_is_required(is_required), m_parser_and_validator(std::move(parser_and_validator))
 	{
 	}
 
-	std::string m_name;
 	bool m_is_required;
-	parser_and_validator_fn m_parser_and_validator;
-	std::any m_value;
+	detail::parser_and_validator_fn m_parser_and_validator;
+	// Constructs the default value, if the variable was registered with one, ignoring the string passed to it.
+	detail::parser_and_validator_fn m_default_value;
+	// Formatted default value for the help message, if the type is formattable.
+	std::optional<std::string> m_default_value_description;
 
 	friend prefix;
 	template <typename Prefix>
@@ -71,7 +77,7 @@ extract_options(const std::initializer_list<std::pair<std::string, T>>& options)
 		option_strings.push_back(str);
 		option_values.push_back(val);
 	}
-	return {option_strings, option_values};
+	return {std::move(option_strings), std::move(option_values)};
 }
 } // namespace detail
 
@@ -114,6 +120,8 @@ class parsed_and_validated_prefix {
 	parsed_and_validated_prefix& operator=(parsed_and_validated_prefix&& other) noexcept
 	{
 		m_prefix = std::move(other.m_prefix);
+		m_environment_owner = std::move(other.m_environment_owner);
+		m_testing_environment = std::move(other.m_testing_environment);
 		m_errors = std::move(other.m_errors);
 		m_warnings = std::move(other.m_warnings);
 		m_invalidated = std::move(other.m_invalidated);
@@ -124,17 +132,43 @@ class parsed_and_validated_prefix {
 	template <typename T, bool IsRequired>
 	[[nodiscard]] auto get(const variable_id<T, IsRequired>& var_id) const
 	{
-		throw_if_invalid();
+		const auto* const value = find_value(var_id);
+		if constexpr (IsRequired) {
+			return *value;
+		} else {
+			return value != nullptr ? std::optional<T>{*value} : std::optional<T>{std::nullopt};
+		}
+	}
 
-		const auto& value = m_prefix.m_registered_vars[var_id.m_idx].m_value;
+	// Same as 'get', but returns a reference to the stored value instead of a copy. The reference stays valid as long
+	// as the parsed and validated prefix is neither destroyed nor moved from.
+	template <typename T, bool IsRequired>
+	[[nodiscard]] std::conditional_t<IsRequired, const T&, std::optional<std::reference_wrapper<const T>>>
+	get_ref(const variable_id<T, IsRequired>& var_id) const&
+	{
+		const auto* const value = find_value(var_id);
 		if constexpr (IsRequired) {
-			if (!value.has_value()) {
-				throw value_error{fmt::format("Variable '{}' does not hold a value",
-				                              m_prefix.m_registered_vars[var_id.m_idx].m_name)};
-			}
-			return std::any_cast<T>(value);
+			return *value;
 		} else {
-			return value.has_value() ? std::optional<T>{std::any_cast<T>(value)} : std::optional<T>{std::nullopt};
+			return value != nullptr ? std::optional<std::reference_wrapper<const T>>{*value} : std::nullopt;
+		}
+	}
+
+	// Deleted to prevent dangling references into temporaries.
+	template <typename T, bool IsRequired>
+	void get_ref(const variable_id<T, IsRequired>& var_id) const&& = delete;
+
+	// Moves the value out of the parsed and validated prefix instead of copying it, which also supports move-only
+	// types, e.g. 'std::move(parsed_and_validated_pre).take(var_id)'. Afterwards the variable no longer holds a value.
+	template <typename T, bool IsRequired>
+	[[nodiscard]] auto take(const variable_id<T, IsRequired>& var_id) &&
+	{
+		const auto has_value = find_value(var_id) != nullptr;
+		auto& values = m_prefix.m_values;
+		if constexpr (IsRequired) {
+			return values.template take<T>(var_id.m_idx);
+		} else {
+			return has_value ? std::optional<T>{values.template take<T>(var_id.m_idx)} : std::optional<T>{std::nullopt};
 		}
 	}
 
@@ -143,10 +177,8 @@ class parsed_and_validated_prefix {
 	{
 		static_assert(!IsRequired, "Default values are not supported on required variables");
 
-		throw_if_invalid();
-
-		const auto& value = m_prefix.m_registered_vars[var_id.m_idx].m_value;
-		return value.has_value() ? std::any_cast<T>(value) : static_cast<T>(std::forward<U>(default_value));
+		const auto* const value = find_value(var_id);
+		return value != nullptr ? *value : static_cast<T>(std::forward<U>(default_value));
 	}
 
 	[[nodiscard]] bool ok() const
@@ -158,13 +190,13 @@ class parsed_and_validated_prefix {
 	[[nodiscard]] std::string error_message() const
 	{
 		throw_if_invalid();
-		return message_formatting_helper("Error", m_errors);
+		return detail::format_messages("Error", m_errors);
 	}
 
 	[[nodiscard]] std::string warning_message() const
 	{
 		throw_if_invalid();
-		return message_formatting_helper("Warning", m_warnings);
+		return detail::format_messages("Warning", m_warnings);
 	}
 
 	[[nodiscard]] const std::vector<error>& errors() const
@@ -193,85 +225,153 @@ class parsed_and_validated_prefix {
 		}
 	}
 
-	parsed_and_validated_prefix(Prefix&& pre, std::unordered_map<std::string, std::string> environment)
+	// Returns the stored value of the variable, or nullptr if it does not hold a value, which is an error for required
+	// variables.
+	template <typename T, bool IsRequired>
+	[[nodiscard]] const T* find_value(const variable_id<T, IsRequired>& var_id) const
+	{
+		throw_if_invalid();
+
+		const auto& values = m_prefix.m_values;
+		if (!values.has_value(var_id.m_idx)) {
+			if constexpr (IsRequired) {
+				throw value_error{
+				    fmt::format("Variable '{}' does not hold a value", m_prefix.m_var_names.name(var_id.m_idx))};
+			}
+			return nullptr;
+		}
+		return &values.template get<T>(var_id.m_idx);
+	}
+
+	// Values of borrowed string types (e.g. 'std::string_view') point into the environment, so if the prefix has
+	// variables of such types, 'environment_owner' must own the environment, which is then kept alive.
+	template <typename Environment>
+	parsed_and_validated_prefix(Prefix&& pre, Environment&& system_environment,
+	                            std::shared_ptr<const void> environment_owner = nullptr)
+	    : parsed_and_validated_prefix(std::move(pre), std::forward<Environment>(system_environment),
+	                                  static_cast<const detail::environment_snapshot*>(nullptr),
+	                                  std::move(environment_owner))
+	{
+	}
+
+	// Same as above, but 'system_environment' only contains the variables starting with the prefix name. Variables
+	// similar to those which are unset are then looked for in 'typo_environment', if it is not nullptr.
+	template <typename Environment, typename TypoEnvironment>
+	parsed_and_validated_prefix(Prefix&& pre, Environment&& system_environment,
+	                            const TypoEnvironment* typo_environment,
+	                            std::shared_ptr<const void> environment_owner)
 	    : m_prefix(std::move(pre))
 	{
-		// Merges the global testing environment into the environment considered for parsing and validating,
+		if (m_prefix.m_has_borrowed_values) {
+			m_environment_owner = std::move(environment_owner);
+			// The global testing environment can change at any time, so it is copied if it is in use.
+			if (!detail::g_testing_environment.empty()) {
+				m_testing_environment = std::make_shared<const testing_environment_t>(detail::g_testing_environment);
+			}
+		}
+		const auto& testing_environment =
+		    m_testing_environment != nullptr ? *m_testing_environment : detail::g_testing_environment;
+
+		// Layers the global testing environment on top of the environment considered for parsing and validating,
 		// giving precedence to variables set in the testing environment.
-		environment = detail::merge_environments(detail::g_testing_environment, environment);
+		using environment_t = std::remove_cv_t<std::remove_reference_t<Environment>>;
+		auto environment = detail::layered_environment<environment_t>(testing_environment, system_environment);
 
 		auto unparsed_env_vars = std::vector<std::size_t>{};
 
+		// All values are parsed directly into the prefix's value arena, which is allocated once upfront.
+		auto& values = m_prefix.m_values;
+		values.allocate();
+
 		for (std::size_t id = 0; id < m_prefix.m_registered_vars.size(); ++id) {
 			auto& var = m_prefix.m_registered_vars[id];
-			const auto var_name = m_prefix.get_full_env_var_name(id);
-			const auto var_value = detail::pop_from_environment(var_name, environment);
-			if (var.m_value.has_value()) {
+			const auto var_name = m_prefix.m_var_names.full_name(id);
+			const auto var_value = detail::pop_from_environment(var_name, m_prefix.m_var_names.hash(id), environment);
+			if (values.has_value(id)) {
 				// Skip variables set for testing, but consume their environment value if available.
 				continue;
 			}
 			if (!var_value.has_value()) {
 				unparsed_env_vars.push_back(id);
 			} else {
-				auto res =
-				    detail::parse_or_error<std::any>(var_name, *var_value, std::move(var.m_parser_and_validator));
-				if (res.has_value()) {
-					var.m_value = std::move(res).value();
+				auto error_msg =
+				    detail::get_parse_and_validate_error(var_name, *var_value, [&](const std::string_view str) {
+					    var.m_parser_and_validator(str, values.get_storage(id));
+				    });
+				if (!error_msg.has_value()) {
+					// Bound variables are parsed into their struct member instead of the arena.
+					if (values.has_value_type(id)) {
+						values.set_constructed(id);
+					}
 				} else {
-					m_errors.emplace_back(id, var.m_name, std::move(res).error());
+					m_errors.emplace_back(id, m_prefix.m_var_names.name(id), std::move(*error_msg));
 				}
 			}
 		}
 
+		// Only if variables are unset, the rest of the environment is searched for similar variables, which are copied
+		// into a snapshot, so that they can be consumed once reported.
+		auto typo_candidates = detail::environment_snapshot{};
+		if (typo_environment != nullptr && !unparsed_env_vars.empty()) {
+			typo_candidates = m_prefix.get_typo_environment_snapshot(*typo_environment, unparsed_env_vars);
+		}
+		const auto no_testing_environment = testing_environment_t{};
+		auto typo_candidates_environment = detail::layered_environment(no_testing_environment, typo_candidates);
+
 		for (const auto id : unparsed_env_vars) {
 			auto& var = m_prefix.m_registered_vars[id];
-			const auto var_name = m_prefix.get_full_env_var_name(id);
+			const auto var_name = m_prefix.m_var_names.full_name(id);
 			const auto edit_distance_cutoff = m_prefix.m_edit_distance_cutoff.get_or_default(var_name.length());
-			auto similar_env_var_error =
-			    detail::get_similar_env_var_error(id, var_name, edit_distance_cutoff, environment);
-			if (similar_env_var_error.has_value()) {
+			const auto similar_env_var = detail::find_similar_env_var(
+			    var_name, environment, typo_candidates_environment, edit_distance_cutoff);
+			if (similar_env_var.has_value()) {
+				environment.consume(*similar_env_var);
+				typo_candidates_environment.consume(*similar_env_var);
+				auto similar_env_var_error = detail::get_similar_env_var_error(id, var_name, *similar_env_var);
 				if (var.m_is_required) {
-					m_errors.push_back(std::move(similar_env_var_error).value());
+					m_errors.push_back(std::move(similar_env_var_error));
 				} else {
-					m_warnings.push_back(std::move(similar_env_var_error).value());
+					m_warnings.push_back(std::move(similar_env_var_error));
 				}
 			} else if (var.m_is_required) {
 				m_errors.push_back(detail::get_unset_env_var_error(id, var_name));
 			}
 		}
 
+		// Variables with default values which are unset or failed to parse resolve to their default value.
+		for (std::size_t id = 0; id < m_prefix.m_registered_vars.size(); ++id) {
+			auto& var = m_prefix.m_registered_vars[id];
+			if (var.m_default_value && !values.has_value(id)) {
+				var.m_default_value({}, values.get_storage(id));
+				values.set_constructed(id);
+			}
+		}
+
 		for (auto&& unused_var : find_unused_env_vars(environment)) {
 			m_warnings.emplace_back(-1, unused_var,
 			                        fmt::format("Prefix environment variable '{}' specified but unused", unused_var));
 		}
 	}
 
-	[[nodiscard]] std::string message_formatting_helper(const std::string_view message_type,
-	                                                    const std::vector<error>& errors_or_warnings) const
-	{
-		if (errors_or_warnings.empty()) {
-			return {};
-		}
-		auto msg = std::string();
-		for (std::size_t i = 0; i < errors_or_warnings.size(); ++i) {
-			msg += fmt::format("{:<7}: {}\n", message_type, errors_or_warnings[i].what());
-		}
-		return msg;
-	}
-
+	template <typename Environment>
 	[[nodiscard]] std::vector<std::string>
-	find_unused_env_vars(const std::unordered_map<std::string, std::string>& environment) const
+	find_unused_env_vars(const detail::layered_environment<Environment>& environment) const
 	{
 		auto unused_env_vars = std::vector<std::string>{};
-		for (const auto& [var, _] : environment) {
-			if (var.find(m_prefix.m_prefix_name) == 0) {
-				unused_env_vars.push_back(var);
+		environment.for_each([&](const std::string_view var, const std::string_view) {
+			const auto& prefix_name = m_prefix.m_var_names.prefix_name();
+			if (var.substr(0, prefix_name.size()) == prefix_name) {
+				unused_env_vars.emplace_back(var);
 			}
-		}
+		});
 		return unused_env_vars;
 	}
 
+	using testing_environment_t = std::remove_cv_t<std::remove_reference_t<decltype(detail::g_testing_environment)>>;
+
 	Prefix m_prefix;
+	std::shared_ptr<const void> m_environment_owner;
+	std::shared_ptr<const testing_environment_t> m_testing_environment;
 	std::vector<error> m_errors;
 	std::vector<error> m_warnings;
 	bool m_invalidated = false;
@@ -284,9 +384,9 @@ class prefix {
 
   public:
 	prefix(const std::string_view prefix_name, const edit_distance edit_distance_cutoff = default_edit_distance)
-	    : m_prefix_name(std::string(prefix_name) + PREFIX_DELIMITER), m_edit_distance_cutoff(edit_distance_cutoff)
+	    : m_var_names(std::string(prefix_name) + PREFIX_DELIMITER), m_edit_distance_cutoff(edit_distance_cutoff)
 	{
-		if (m_prefix_name.size() == 1 && m_prefix_name[0] == PREFIX_DELIMITER) {
+		if (prefix_name.empty()) {
 			throw invalid_prefix{"Prefix name must not be empty"};
 		}
 	}
@@ -297,9 +397,11 @@ class prefix {
 	prefix& operator=(const prefix&) = delete;
 	prefix& operator=(prefix&& other) noexcept
 	{
-		m_prefix_name = std::move(other.m_prefix_name);
+		m_var_names = std::move(other.m_var_names);
 		m_edit_distance_cutoff = std::move(other.m_edit_distance_cutoff);
 		m_registered_vars = std::move(other.m_registered_vars);
+		m_values = std::move(other.m_values);
+		m_has_borrowed_values = std::move(other.m_has_borrowed_values);
 		m_invalidated = std::move(other.m_invalidated);
 		other.m_invalidated = true;
 		return *this;
@@ -307,11 +409,27 @@ class prefix {
 
 	~prefix() = default;
 
-	template <typename T, typename ParserAndValidatorFn = decltype(default_parser_and_validator<T>{})>
-	[[nodiscard]] auto register_variable(const std::string_view name,
-	                                     ParserAndValidatorFn parser_and_validator = default_parser_and_validator<T>{})
+	// The second argument is either a parser and validator, i.e. it is invocable with a 'std::string_view', or the
+	// default value of the variable. Variables with a default value always hold a value after parsing and validating,
+	// so their IDs behave like those of required variables, without the variable being required to be set.
+	template <typename T, typename ParserAndValidatorFnOrDefault = decltype(default_parser_and_validator<T>{})>
+	[[nodiscard]] auto
+	register_variable(const std::string_view name,
+	                  ParserAndValidatorFnOrDefault&& arg = default_parser_and_validator<T>{})
+	{
+		if constexpr (std::is_invocable_v<std::decay_t<ParserAndValidatorFnOrDefault>&, std::string_view>) {
+			return registration_helper<T, false>(name, std::forward<ParserAndValidatorFnOrDefault>(arg));
+		} else {
+			return registration_default_helper<T>(name, std::forward<ParserAndValidatorFnOrDefault>(arg),
+			                                      default_parser_and_validator<T>{});
+		}
+	}
+
+	template <typename T, typename U, typename ParserAndValidatorFn>
+	[[nodiscard]] auto register_variable(const std::string_view name, U&& default_value,
+	                                     ParserAndValidatorFn parser_and_validator)
 	{
-		return registration_helper<T, false>(name, std::move(parser_and_validator));
+		return registration_default_helper<T>(name, std::forward<U>(default_value), std::move(parser_and_validator));
 	}
 
 	template <typename T, typename ParserAndValidatorFn = decltype(default_parser_and_validator<T>{})>
@@ -334,6 +452,19 @@ class prefix {
 		return registration_range_helper<T, true>(name, min, max);
 	}
 
+	// Registers an option variable with the options given by the specialization of 'option_traits' for 'T'.
+	template <typename T>
+	[[nodiscard]] auto register_option(const std::string_view name)
+	{
+		return registration_option_traits_helper<T, false>(name);
+	}
+
+	template <typename T>
+	[[nodiscard]] auto register_required_option(const std::string_view name)
+	{
+		return registration_option_traits_helper<T, true>(name);
+	}
+
 	template <typename T>
 	[[nodiscard]] auto register_option(const std::string_view name, const std::initializer_list<T> options)
 	{
@@ -344,8 +475,8 @@ class prefix {
 	[[nodiscard]] auto register_option(const std::string_view name,
 	                                   const std::initializer_list<std::pair<std::string, T>> options)
 	{
-		const auto [option_strings, option_values] = detail::extract_options(options);
-		return registration_option_helper<T, false, true>(name, option_values, option_strings);
+		auto [option_strings, option_values] = detail::extract_options(options);
+		return registration_option_helper<T, false, true>(name, std::move(option_values), std::move(option_strings));
 	}
 
 	template <typename T>
@@ -358,30 +489,76 @@ class prefix {
 	[[nodiscard]] auto register_required_option(const std::string_view name,
 	                                            const std::initializer_list<std::pair<std::string, T>> options)
 	{
-		const auto [option_strings, option_values] = detail::extract_options(options);
-		return registration_option_helper<T, true, true>(name, option_values, option_strings);
+		auto [option_strings, option_values] = detail::extract_options(options);
+		return registration_option_helper<T, true, true>(name, std::move(option_values), std::move(option_strings));
 	}
 
 	void register_deprecated(const std::string_view name, const std::string_view deprecation_message)
 	{
 		throw_if_invalid();
-		std::string dm{deprecation_message};
-		m_registered_vars.push_back(detail::variable_data{
-		    name, false, [dm](const std::string_view) -> std::any { throw validation_error(dm); }});
+		auto deprecated = [dm = std::string(deprecation_message)](const std::string_view) {
+			throw validation_error(dm);
+		};
+		register_variable_data(
+		    name, false, detail::parser_and_validator_fn(std::in_place_type<void>, std::move(deprecated)), nullptr);
+	}
+
+	// Binds the variable 'name' to the member 'member' of 'config', i.e. the variable is parsed and validated directly
+	// into the member instead of being stored in the prefix. The member keeps its value if the variable is unset or
+	// fails to parse, and 'config' must outlive parsing and validating the prefix.
+	template <typename Config, typename T,
+	          typename ParserAndValidatorFn = decltype(default_parser_and_validator<T>{})>
+	void bind(const std::string_view name, Config& config, T Config::*member,
+	          ParserAndValidatorFn parser_and_validator = default_parser_and_validator<T>{})
+	{
+		binding_helper<false>(name, config, member, std::move(parser_and_validator));
+	}
+
+	template <typename Config, typename T,
+	          typename ParserAndValidatorFn = decltype(default_parser_and_validator<T>{})>
+	void bind_required(const std::string_view name, Config& config, T Config::*member,
+	                   ParserAndValidatorFn parser_and_validator = default_parser_and_validator<T>{})
+	{
+		binding_helper<true>(name, config, member, std::move(parser_and_validator));
 	}
 
 	template <typename T, bool IsRequired, typename U = T>
-	void set_for_testing(const variable_id<T, IsRequired>& var_id, const U& value)
+	void set_for_testing(const variable_id<T, IsRequired>& var_id, U&& value)
 	{
 		throw_if_invalid();
-		m_registered_vars[var_id.m_idx].m_value = static_cast<T>(value);
+		m_values.emplace<T>(var_id.m_idx, static_cast<T>(std::forward<U>(value)));
+	}
+
+	[[nodiscard]] parsed_and_validated_prefix<prefix> parse_and_validate()
+	{
+		throw_if_invalid();
+		// Only the variables relevant to this prefix are copied into a snapshot owned by this call, so variables can be
+		// consumed directly within it. The snapshot is taken from the process-wide snapshot if it is up to date, which
+		// is cheaper to iterate than the process environment.
+		if (const auto system_environment = detail::get_current_environment_snapshot(); system_environment != nullptr) {
+			return parse_and_validate_with_prefix_snapshot(*system_environment);
+		}
+		return parse_and_validate_with_prefix_snapshot(detail::get_environment_view());
 	}
 
 	[[nodiscard]] parsed_and_validated_prefix<prefix>
-	parse_and_validate(std::unordered_map<std::string, std::string> environment = detail::get_environment())
+	parse_and_validate(const std::unordered_map<std::string, std::string>& environment)
+	{
+		return parse_and_validate<std::unordered_map<std::string, std::string>>(environment);
+	}
+
+	// Parses and validates the prefix using a custom environment, which can be of any type supported by
+	// 'environment_source'. The environment is neither copied nor modified, unless the prefix has variables of borrowed
+	// string types (e.g. 'std::string_view'), in which case the relevant variables are copied into a snapshot owned by
+	// the parsed and validated prefix.
+	template <typename Environment>
+	[[nodiscard]] parsed_and_validated_prefix<prefix> parse_and_validate(const Environment& environment)
 	{
 		throw_if_invalid();
-		return {std::move(*this), std::move(environment)};
+		if (m_has_borrowed_values) {
+			return parse_and_validate_with_owned_snapshot(environment);
+		}
+		return {std::move(*this), environment};
 	}
 
 	[[nodiscard]] std::string help_message() const
@@ -389,14 +566,19 @@ class prefix {
 		throw_if_invalid();
 
 		if (m_registered_vars.empty()) {
-			return fmt::format("There are no supported environment variables for the prefix '{}'\n", m_prefix_name);
+			return fmt::format("There are no supported environment variables for the prefix '{}'\n",
+			                   m_var_names.prefix_name());
 		}
-		auto msg = fmt::format("Prefix '{}' supports the following {} environment variable(s):\n", m_prefix_name,
-		                       m_registered_vars.size());
+		auto msg = fmt::format("Prefix '{}' supports the following {} environment variable(s):\n",
+		                       m_var_names.prefix_name(), m_registered_vars.size());
 		for (std::size_t i = 0; i < m_registered_vars.size(); ++i) {
 			const auto& var = m_registered_vars[i];
-			const auto var_name = get_full_env_var_name(i);
-			msg += fmt::format("\t'{}' {}\n", var_name, var.m_is_required ? "required" : "optional");
+			const auto var_name = m_var_names.full_name(i);
+			if (var.m_default_value_description.has_value()) {
+				msg += fmt::format("\t'{}' optional (default: {})\n", var_name, *var.m_default_value_description);
+			} else {
+				msg += fmt::format("\t'{}' {}\n", var_name, var.m_is_required ? "required" : "optional");
+			}
 		}
 		return msg;
 	}
@@ -404,14 +586,10 @@ class prefix {
   private:
 	prefix() = default;
 
-	[[nodiscard]] std::string get_full_env_var_name(const std::size_t var_id) const
-	{
-		return get_full_env_var_name(m_registered_vars[var_id].m_name);
-	}
-
+	// Only used for error messages during registration, the full names of registered variables are precomputed.
 	[[nodiscard]] std::string get_full_env_var_name(const std::string_view name) const
 	{
-		return m_prefix_name + std::string(name);
+		return m_var_names.prefix_name() + std::string(name);
 	}
 
 	void throw_if_invalid() const
@@ -422,20 +600,120 @@ class prefix {
 		}
 	}
 
+	// Takes a snapshot of only those variables of 'environment' which start with the prefix name.
+	template <typename Environment>
+	[[nodiscard]] detail::environment_snapshot get_prefix_environment_snapshot(const Environment& environment) const
+	{
+		const auto& prefix_name = m_var_names.prefix_name();
+		return detail::environment_snapshot(environment, [&](const std::string_view name) {
+			return name.substr(0, prefix_name.size()) == prefix_name;
+		});
+	}
+
+	// Takes a snapshot of those variables of 'environment' which do not start with the prefix name, but are similar
+	// enough to one of the variables 'ids' to be reported as typos.
+	template <typename Environment>
+	[[nodiscard]] detail::environment_snapshot get_typo_environment_snapshot(const Environment& environment,
+	                                                                         const std::vector<std::size_t>& ids) const
+	{
+		auto var_names_and_cutoffs = std::vector<std::pair<std::string_view, int>>{};
+		var_names_and_cutoffs.reserve(ids.size());
+		for (const auto id : ids) {
+			const auto var_name = m_var_names.full_name(id);
+			var_names_and_cutoffs.emplace_back(var_name, m_edit_distance_cutoff.get_or_default(var_name.length()));
+		}
+
+		const auto& prefix_name = m_var_names.prefix_name();
+		return detail::environment_snapshot(environment, [&](const std::string_view name) {
+			if (name.substr(0, prefix_name.size()) == prefix_name) {
+				return false;
+			}
+			return std::any_of(var_names_and_cutoffs.begin(), var_names_and_cutoffs.end(), [&](const auto& var) {
+				return detail::bounded_edit_distance(name, var.first, var.second + 1) <= var.second;
+			});
+		});
+	}
+
+	template <typename Environment>
+	[[nodiscard]] parsed_and_validated_prefix<prefix>
+	parse_and_validate_with_owned_snapshot(const Environment& environment)
+	{
+		auto snapshot = std::make_shared<detail::environment_snapshot>(get_prefix_environment_snapshot(environment));
+		auto& snapshot_ref = *snapshot;
+		return {std::move(*this), snapshot_ref, &environment, std::move(snapshot)};
+	}
+
+	// Parses and validates a snapshot of the variables starting with the prefix name, in which variables are consumed
+	// in place. Similar variables are only looked for in the rest of 'environment' if variables are unset.
+	template <typename Environment>
+	[[nodiscard]] parsed_and_validated_prefix<prefix>
+	parse_and_validate_with_prefix_snapshot(const Environment& environment)
+	{
+		if (m_has_borrowed_values) {
+			return parse_and_validate_with_owned_snapshot(environment);
+		}
+		auto snapshot = get_prefix_environment_snapshot(environment);
+		return {std::move(*this), snapshot, &environment, nullptr};
+	}
+
+	// Not templated, so that only the type erasure of the parser and validator is instantiated per variable type. The
+	// value type determines the variable's slot in the value arena, or nullptr if the variable never holds a value.
+	std::size_t register_variable_data(const std::string_view name, const bool is_required,
+	                                   detail::parser_and_validator_fn parser_and_validator,
+	                                   const detail::value_type_info* value_type)
+	{
+		m_registered_vars.push_back(detail::variable_data{is_required, std::move(parser_and_validator)});
+		m_var_names.add(name);
+		m_values.add_slot(value_type);
+		return m_registered_vars.size() - 1;
+	}
+
 	template <typename T, bool IsRequired, typename ParserAndValidatorFn>
 	[[nodiscard]] auto registration_helper(const std::string_view name, ParserAndValidatorFn&& parser_and_validator)
 	{
 		throw_if_invalid();
+		if constexpr (detail::is_borrowed_string_v<T>) {
+			m_has_borrowed_values = true;
+		}
+		auto type_erased_parser_and_validator = detail::parser_and_validator_fn(
+		    std::in_place_type<T>, std::forward<ParserAndValidatorFn>(parser_and_validator));
+		return variable_id<T, IsRequired>{register_variable_data(
+		    name, IsRequired, std::move(type_erased_parser_and_validator), &detail::value_type_info_v<T>)};
+	}
 
-		const auto type_erased_parser_and_validator =
-		    [parser_and_validator](const std::string_view env_value) -> std::any {
-			static_assert(std::is_convertible_v<decltype(parser_and_validator(env_value)), T>,
-			              "Parser and validator function must return type convertible to T");
-			return parser_and_validator(env_value);
-		};
-		m_registered_vars.push_back(
-		    detail::variable_data{name, IsRequired, std::move(type_erased_parser_and_validator)});
-		return variable_id<T, IsRequired>{m_registered_vars.size() - 1};
+	template <bool IsRequired, typename Config, typename T, typename ParserAndValidatorFn>
+	void binding_helper(const std::string_view name, Config& config, T Config::*member,
+	                    ParserAndValidatorFn&& parser_and_validator)
+	{
+		static_assert(!detail::is_borrowed_string_v<T>,
+		              "Borrowed string types cannot be bound, as they would outlive the environment they point into");
+		throw_if_invalid();
+		auto bound_parser_and_validator = [config = &config, member,
+		                                   fn = std::forward<ParserAndValidatorFn>(parser_and_validator)](
+		                                      const std::string_view str) mutable { config->*member = fn(str); };
+		register_variable_data(
+		    name, IsRequired,
+		    detail::parser_and_validator_fn(std::in_place_type<void>, std::move(bound_parser_and_validator)), nullptr);
+	}
+
+	template <typename T, typename U, typename ParserAndValidatorFn>
+	[[nodiscard]] auto registration_default_helper(const std::string_view name, U&& default_value,
+	                                               ParserAndValidatorFn&& parser_and_validator)
+	{
+		auto value = static_cast<T>(std::forward<U>(default_value));
+		auto description = std::optional<std::string>{};
+		if constexpr (fmt::is_formattable<T>::value) {
+			description = fmt::format("{}", value);
+		}
+		const auto var_id =
+		    registration_helper<T, true>(name, std::forward<ParserAndValidatorFn>(parser_and_validator));
+		auto& var = m_registered_vars[var_id.m_idx];
+		var.m_is_required = false;
+		// Prefixes are parsed and validated at most once, so the default value can be moved out.
+		auto default_value_fn = [value = std::move(value)](const std::string_view) mutable { return std::move(value); };
+		var.m_default_value = detail::parser_and_validator_fn(std::in_place_type<T>, std::move(default_value_fn));
+		var.m_default_value_description = std::move(description);
+		return var_id;
 	}
 
 	template <typename T, bool IsRequired>
@@ -458,47 +736,64 @@ class prefix {
 	}
 
 	template <typename T, bool IsRequired, bool SimpleParsing = false>
-	[[nodiscard]] auto registration_option_helper(const std::string_view name, const std::vector<T> options,
-	                                              const std::vector<std::string> option_strings = {})
+	[[nodiscard]] auto registration_option_helper(const std::string_view name, std::vector<T> options,
+	                                              std::vector<std::string> option_strings = {})
 	{
 		if (options.size() == 0) {
 			throw empty_option{fmt::format("No options provided for '{}'", get_full_env_var_name(name))};
 		}
 
-		const auto options_set = std::set(options.begin(), options.end());
-		if (options_set.size() != options.size()) {
+		auto option_table = detail::option_table<T>(std::move(options), std::move(option_strings));
+		if (option_table.has_duplicates()) {
 			throw duplicate_option{fmt::format("Duplicate option specified for '{}'", get_full_env_var_name(name))};
 		}
-		const auto parser_and_validator = [options = std::move(options),
-		                                   strings = std::move(option_strings)](const std::string_view str) {
-			const auto value = [&]() {
-				if constexpr (SimpleParsing) {
-					if (strings.size() != options.size()) {
-						throw option_error{fmt::format("Option strings must be provided for simple option parsing")};
-					}
-					const auto it = std::find(strings.begin(), strings.end(), str);
-					if (it != strings.end()) {
-						return options.at(std::distance(strings.begin(), it));
-					} else {
-						throw option_error{fmt::format("Unrecognized option '{}', should be one of [{}]", str,
-						                               fmt::join(strings, ", "))};
-					}
-				} else {
-					return default_parser<T>{}(str);
+		auto parser_and_validator = [options = std::move(option_table)](const std::string_view str) {
+			if constexpr (SimpleParsing) {
+				const auto* const value = options.find(str);
+				if (value == nullptr) {
+					throw option_error{fmt::format("Unrecognized option '{}', should be one of [{}]", str,
+					                               fmt::join(options.option_strings(), ", "))};
 				}
-			}();
-			default_validator<T>{}(value);
-			if (std::all_of(options.begin(), options.end(), [&value](const auto& option) { return option != value; })) {
-				throw option_error{fmt::format("Unrecognized option '{}'", str)};
+				default_validator<T>{}(*value);
+				return *value;
+			} else {
+				const auto value = default_parser<T>{}(str);
+				default_validator<T>{}(value);
+				if (!options.contains(value)) {
+					throw option_error{fmt::format("Unrecognized option '{}'", str)};
+				}
+				return value;
 			}
-			return value;
+		};
+		static_assert(detail::parser_and_validator_fn::is_stored_inline<decltype(parser_and_validator)>,
+		              "Option parsers must be stored inline");
+		return registration_helper<T, IsRequired>(name, std::move(parser_and_validator));
+	}
+
+	template <typename T, bool IsRequired>
+	[[nodiscard]] auto registration_option_traits_helper(const std::string_view name)
+	{
+		static_assert(detail::has_option_traits_v<T>,
+		              "Type must specialize 'option_traits' to be registered without explicit options");
+
+		const auto parser_and_validator = [](const std::string_view str) {
+			using option_table = detail::static_option_table<T>;
+			const auto* const value = option_table::find(str);
+			if (value == nullptr) {
+				throw option_error{fmt::format("Unrecognized option '{}', should be one of [{}]", str,
+				                               fmt::join(option_table::names, ", "))};
+			}
+			default_validator<T>{}(*value);
+			return *value;
 		};
 		return registration_helper<T, IsRequired>(name, std::move(parser_and_validator));
 	}
 
-	std::string m_prefix_name;
+	detail::name_pool m_var_names;
 	edit_distance m_edit_distance_cutoff;
 	std::vector<detail::variable_data> m_registered_vars;
+	detail::value_arena m_values;
+	bool m_has_borrowed_values = false;
 	bool m_invalidated = false;
 
 	template <typename Prefix>
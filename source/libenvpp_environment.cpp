@@ -1,48 +1,79 @@
 #include <libenvpp/detail/environment.hpp>
 
-#include <algorithm>
-#include <iterator>
+#include <atomic>
+#include <mutex>
 #include <utility>
-#include <vector>
-
-#include <libenvpp/detail/levenshtein.hpp>
 
 namespace env::detail {
 
-[[nodiscard]] std::optional<std::string>
-find_similar_env_var(const std::string_view var_name, const std::unordered_map<std::string, std::string>& environment,
-                     const int edit_distance_cutoff)
+namespace {
+
+std::atomic<std::uint64_t> g_environment_generation{0};
+
+struct cached_environment_snapshot {
+	std::mutex mutex;
+	std::shared_ptr<const environment_snapshot> snapshot;
+	std::uint64_t generation = 0;
+};
+
+[[nodiscard]] cached_environment_snapshot& get_cached_environment_snapshot()
 {
-	if (environment.empty()) {
-		return std::nullopt;
-	}
+	static auto cache = cached_environment_snapshot{};
+	return cache;
+}
 
-	auto edit_distances = std::vector<std::pair<int, std::string>>{};
-	std::transform(
-	    environment.begin(), environment.end(), std::back_inserter(edit_distances),
-	    [&var_name, &edit_distance_cutoff](const auto& entry) {
-		    return std::pair{levenshtein::distance(var_name, entry.first, edit_distance_cutoff + 1), entry.first};
-	    });
-	std::sort(edit_distances.begin(), edit_distances.end(),
-	          [](const auto& a, const auto& b) { return a.first < b.first; });
-	const auto& [edit_dist, var] = edit_distances.front();
-	if (edit_dist <= edit_distance_cutoff) {
-		return var;
+} // namespace
+
+[[nodiscard]] std::unordered_map<std::string, std::string> get_environment()
+{
+	const auto environment = get_environment_view();
+
+	auto env_map = std::unordered_map<std::string, std::string>{};
+	env_map.reserve(environment.size());
+	for (const auto [name, value] : environment) {
+		// Later entries of the same name overwrite earlier ones.
+		env_map.insert_or_assign(std::string(name), std::string(value));
 	}
+	return env_map;
+}
+
+[[nodiscard]] std::shared_ptr<const environment_snapshot> get_environment_snapshot()
+{
+	auto& cache = get_cached_environment_snapshot();
+	const auto lock = std::lock_guard(cache.mutex);
 
-	return std::nullopt;
+	// The generation is read before the environment, so a concurrent change outdates the new snapshot right away.
+	const auto generation = g_environment_generation.load(std::memory_order_acquire);
+	if (cache.snapshot == nullptr || cache.generation != generation) {
+		cache.snapshot = std::make_shared<const environment_snapshot>(get_environment_view());
+		cache.generation = generation;
+	}
+	return cache.snapshot;
 }
 
-std::optional<std::string> pop_from_environment(const std::string_view env_var,
-                                                std::unordered_map<std::string, std::string>& environment)
+[[nodiscard]] std::shared_ptr<const environment_snapshot> get_current_environment_snapshot()
 {
-	const auto var_it = environment.find(std::string(env_var));
-	if (var_it == environment.end()) {
-		return std::nullopt;
+	auto& cache = get_cached_environment_snapshot();
+	const auto lock = std::lock_guard(cache.mutex);
+
+	if (cache.generation != g_environment_generation.load(std::memory_order_acquire)) {
+		return nullptr;
 	}
-	const auto [_, val] = *var_it;
-	environment.erase(var_it);
-	return val;
+	return cache.snapshot;
+}
+
+void invalidate_environment_snapshot() noexcept
+{
+	g_environment_generation.fetch_add(1, std::memory_order_acq_rel);
 }
 
 } // namespace env::detail
+
+namespace env {
+
+void refresh_snapshot() noexcept
+{
+	detail::invalidate_environment_snapshot();
+}
+
+} // namespace env
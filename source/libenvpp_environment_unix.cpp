@@ -4,36 +4,15 @@
 
 #include <stdlib.h>
 
-#include <array>
-
 #include <libenvpp/detail/check.hpp>
 
 extern "C" const char* const* const environ;
 
 namespace env::detail {
 
-[[nodiscard]] std::unordered_map<std::string, std::string> get_environment()
+[[nodiscard]] environment_view get_environment_view()
 {
-	auto env_map = std::unordered_map<std::string, std::string>{};
-
-	if (!environ) {
-		return env_map;
-	}
-
-	for (auto var = environ; *var; ++var) {
-		auto var_name_value = std::array<std::string, 2>{};
-		auto idx = std::size_t{0};
-		for (auto val = *var; *val; ++val) {
-			if (idx == 0 && *val == '=') {
-				++idx;
-			} else {
-				var_name_value[idx] += *val;
-			}
-		}
-		env_map[var_name_value[0]] = var_name_value[1];
-	}
-
-	return env_map;
+	return environment_view(environ);
 }
 
 [[nodiscard]] std::optional<std::string> get_environment_variable(const std::string_view name)
@@ -49,12 +28,14 @@ void set_environment_variable(const std::string_view name, const std::string_vie
 {
 	[[maybe_unused]] const auto env_var_was_set = setenv(std::string(name).c_str(), std::string(value).c_str(), true);
 	LIBENVPP_CHECK(env_var_was_set == 0);
+	invalidate_environment_snapshot();
 }
 
 void delete_environment_variable(const std::string_view name)
 {
 	[[maybe_unused]] const auto env_var_was_deleted = unsetenv(std::string(name).c_str());
 	LIBENVPP_CHECK(env_var_was_deleted == 0);
+	invalidate_environment_snapshot();
 }
 
 } // namespace env::detail
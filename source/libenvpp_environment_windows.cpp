@@ -10,7 +10,11 @@
 #endif
 #include <windows.h>
 
-#include <array>
+#include <algorithm>
+#include <cwchar>
+#include <memory>
+#include <string_view>
+#include <vector>
 
 #include <libenvpp/detail/check.hpp>
 
@@ -49,38 +53,45 @@ std::optional<std::wstring> convert_string(const std::string& str)
 	return buffer;
 }
 
-[[nodiscard]] std::unordered_map<std::string, std::string> get_environment()
+[[nodiscard]] environment_view get_environment_view()
 {
-	auto env_map = std::unordered_map<std::string, std::string>{};
-
 	const auto environment = GetEnvironmentStringsW();
 	if (!environment) {
-		return env_map;
+		return environment_view();
 	}
 
-	for (const auto* var = environment; *var; ++var) {
-		auto var_name_value = std::array<std::wstring, 2>{};
-		auto idx = std::size_t{0};
-		for (; *var; ++var) {
-			if (idx == 0 && *var == L'=') {
-				++idx;
-			} else {
-				var_name_value[idx] += *var;
-			}
+	// Converts all entries into a single buffer of null-terminated UTF-8 strings, which is owned by the view.
+	auto converted_vars = std::string();
+	auto var_offsets = std::vector<std::size_t>{};
+	for (const auto* var = environment; *var;) {
+		const auto var_length = std::wcslen(var);
+		const auto var_name_value = std::wstring_view(var, var_length);
+		var += var_length + 1;
+
+		const auto delimiter = var_name_value.find(L'=');
+		if (delimiter == 0 || var_name_value.empty()) {
+			// Skip hidden entries like "=C:=C:\" which store per drive working directories.
+			continue;
 		}
-		if (!var_name_value[0].empty()) {
-			auto key = convert_string(var_name_value[0]);
-			auto value = convert_string(var_name_value[1]);
-			if (key && value) {
-				env_map[*key] = *value;
-			}
+		const auto converted_var = convert_string(std::wstring(var_name_value));
+		if (converted_var) {
+			var_offsets.push_back(converted_vars.size());
+			converted_vars += *converted_var;
+			converted_vars += '\0';
 		}
 	}
 
 	[[maybe_unused]] const auto env_strings_were_freed = FreeEnvironmentStringsW(environment);
 	LIBENVPP_CHECK(env_strings_were_freed);
 
-	return env_map;
+	auto storage = std::make_unique<char[]>(converted_vars.size());
+	std::copy(converted_vars.begin(), converted_vars.end(), storage.get());
+	auto vars = std::vector<const char*>{};
+	vars.reserve(var_offsets.size() + 1);
+	for (const auto offset : var_offsets) {
+		vars.push_back(storage.get() + offset);
+	}
+	return environment_view(std::move(storage), std::move(vars));
 }
 
 [[nodiscard]] std::optional<std::string> get_environment_variable(const std::string_view name)
@@ -110,6 +121,7 @@ void set_environment_variable(const std::string_view name, const std::string_vie
 	}
 	[[maybe_unused]] const auto env_var_was_set = SetEnvironmentVariableW(key->c_str(), val->c_str());
 	LIBENVPP_CHECK(env_var_was_set);
+	invalidate_environment_snapshot();
 }
 
 void delete_environment_variable(const std::string_view name)
@@ -120,6 +132,7 @@ void delete_environment_variable(const std::string_view name)
 	}
 	[[maybe_unused]] const auto env_var_was_deleted = SetEnvironmentVariableW(key->c_str(), nullptr);
 	LIBENVPP_CHECK(env_var_was_deleted);
+	invalidate_environment_snapshot();
 }
 
 } // namespace env::detail
@@ -2,22 +2,14 @@
 
 #include <fmt/format.h>
 
-#include <libenvpp/detail/environment.hpp>
-
 namespace env::detail {
 
-[[nodiscard]] std::optional<error> get_similar_env_var_error(const std::size_t id, const std::string_view env_var_name,
-                                                             const int edit_dist_cutoff,
-                                                             std::unordered_map<std::string, std::string>& environment)
+[[nodiscard]] error get_similar_env_var_error(const std::size_t id, const std::string_view env_var_name,
+                                              const std::string_view similar_env_var_name)
 {
-	const auto similar_var = find_similar_env_var(env_var_name, environment, edit_dist_cutoff);
-	if (similar_var.has_value()) {
-		const auto msg =
-		    fmt::format("Unrecognized environment variable '{}' set, did you mean '{}'?", *similar_var, env_var_name);
-		pop_from_environment(*similar_var, environment);
-		return {error(id, env_var_name, msg)};
-	}
-	return std::nullopt;
+	return error(id, env_var_name,
+	             fmt::format("Unrecognized environment variable '{}' set, did you mean '{}'?", similar_env_var_name,
+	                         env_var_name));
 }
 
 [[nodiscard]] error get_unset_env_var_error(const std::size_t id, const std::string_view env_var_name)
@@ -25,4 +17,14 @@ namespace env::detail {
 	return error(id, env_var_name, fmt::format("Environment variable '{}' not set", env_var_name));
 }
 
+[[nodiscard]] std::string format_messages(const std::string_view message_type,
+                                          const std::vector<error>& errors_or_warnings)
+{
+	auto msg = std::string();
+	for (const auto& error_or_warning : errors_or_warnings) {
+		msg += fmt::format("{:<7}: {}\n", message_type, error_or_warning.what());
+	}
+	return msg;
+}
+
 } // namespace env::detail
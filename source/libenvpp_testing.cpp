@@ -2,6 +2,7 @@
 
 #include <fmt/format.h>
 
+#include <libenvpp/detail/environment.hpp>
 #include <libenvpp/detail/errors.hpp>
 
 namespace env {
@@ -10,17 +11,6 @@ namespace detail {
 
 std::unordered_map<std::string, std::string> g_testing_environment;
 
-[[nodiscard]] std::unordered_map<std::string, std::string>
-merge_environments(const std::unordered_map<std::string, std::string>& high_precedence_env,
-                   const std::unordered_map<std::string, std::string>& low_precedence_env)
-{
-	auto merged = low_precedence_env;
-	for (const auto& [name, value] : high_precedence_env) {
-		merged[name] = value;
-	}
-	return merged;
-}
-
 } // namespace detail
 
 scoped_test_environment::scoped_test_environment(const std::unordered_map<std::string, std::string>& environment)
@@ -34,6 +24,7 @@ scoped_test_environment::scoped_test_environment(const std::unordered_map<std::s
 		}
 		detail::g_testing_environment[name] = value;
 	}
+	detail::invalidate_environment_snapshot();
 }
 
 scoped_test_environment::scoped_test_environment(const std::string_view name, const std::string_view value)
@@ -46,6 +37,7 @@ scoped_test_environment::~scoped_test_environment()
 	for (const auto& [name, _] : m_environment) {
 		detail::g_testing_environment.erase(name);
 	}
+	detail::invalidate_environment_snapshot();
 }
 
 } // namespace env
@@ -1,7 +1,16 @@
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
 
 #include <libenvpp/detail/environment.hpp>
+#include <libenvpp/detail/name_pool.hpp>
 
 namespace env::detail {
 
@@ -202,6 +211,244 @@ TEST_CASE("Environment contains set variables", "[libenvpp_env]")
 	CHECK_THAT(environment.at(test_var_name), Equals(test_var_value));
 }
 
+TEST_CASE("Environment view contains set variables", "[libenvpp_env]")
+{
+	constexpr auto test_var_name = "LIBENVPP_TESTING_VIEW";
+	constexpr auto test_var_value = "value=with=delimiters";
+
+	const auto _ = set_scoped_environment_variable{test_var_name, test_var_value};
+
+	const auto environment = get_environment_view();
+	REQUIRE_FALSE(environment.empty());
+	CHECK(environment.size() == get_environment().size());
+
+	const auto value = environment.find(test_var_name);
+	REQUIRE(value.has_value());
+	CHECK(*value == test_var_value);
+
+	CHECK_FALSE(environment.find("LIBENVPP_TESTING").has_value());
+	CHECK_FALSE(environment.find("LIBENVPP_TESTING_VIEW_").has_value());
+
+	auto num_found = 0;
+	for (const auto [name, val] : environment) {
+		if (name == test_var_name) {
+			CHECK(val == test_var_value);
+			++num_found;
+		}
+	}
+	CHECK(num_found == 1);
+}
+
+TEST_CASE("Environment view of custom entries", "[libenvpp_env]")
+{
+	constexpr const char* vars[] = {"FOO=bar", "EMPTY=", "NO_DELIMITER", "MULTIPLE==delimiters=", nullptr};
+
+	const auto environment = environment_view(vars);
+	REQUIRE(environment.size() == 4);
+
+	CHECK(environment.find("FOO") == "bar");
+	CHECK(environment.find("EMPTY") == "");
+	CHECK(environment.find("NO_DELIMITER") == "");
+	CHECK(environment.find("MULTIPLE") == "=delimiters=");
+	CHECK_FALSE(environment.find("FO").has_value());
+	CHECK_FALSE(environment.find("bar").has_value());
+
+	auto it = environment.begin();
+	CHECK((*it).name == "FOO");
+	CHECK((*it).value == "bar");
+	++it;
+	CHECK((*it).name == "EMPTY");
+	CHECK((*it).value.empty());
+	++it;
+	CHECK((*it).name == "NO_DELIMITER");
+	CHECK((*it).value.empty());
+	++it;
+	CHECK((*it).name == "MULTIPLE");
+	CHECK((*it).value == "=delimiters=");
+	++it;
+	CHECK(it == environment.end());
+}
+
+TEST_CASE("Environment snapshot only contains relevant entries", "[libenvpp_env]")
+{
+	constexpr const char* vars[] = {"PREFIX_FOO=foo", "OTHER=other", "PREFIX_BAR=", "PREFIX=prefix", nullptr};
+	const auto environment = environment_view(vars);
+
+	const auto snapshot = environment_snapshot(
+	    environment, [](const std::string_view name) { return name.substr(0, 7) == "PREFIX_"; });
+	REQUIRE(snapshot.size() == 2);
+	CHECK(snapshot.find("PREFIX_FOO") == "foo");
+	CHECK(snapshot.find("PREFIX_BAR") == "");
+	CHECK_FALSE(snapshot.find("OTHER").has_value());
+	CHECK_FALSE(snapshot.find("PREFIX").has_value());
+
+	auto it = snapshot.begin();
+	CHECK((*it).name == "PREFIX_FOO");
+	CHECK((*it).value == "foo");
+	++it;
+	CHECK((*it).name == "PREFIX_BAR");
+	CHECK((*it).value.empty());
+	++it;
+	CHECK(it == snapshot.end());
+
+	const auto empty_snapshot = environment_snapshot(environment, [](const std::string_view) { return false; });
+	CHECK(empty_snapshot.empty());
+	CHECK(empty_snapshot.begin() == empty_snapshot.end());
+}
+
+TEST_CASE("Environment snapshot lookup and consumption", "[libenvpp_env]")
+{
+	constexpr const char* vars[] = {"FOO=foo", "BAR=bar", "FOO=shadowed", "EMPTY=", "BAZ=baz", nullptr};
+	auto snapshot = environment_snapshot(environment_view(vars));
+
+	REQUIRE(snapshot.size() == 4);
+	CHECK(snapshot.find("FOO") == "foo");
+	CHECK(snapshot.find("BAR") == "bar");
+	CHECK(snapshot.find("EMPTY") == "");
+	CHECK(snapshot.find("BAZ") == "baz");
+	CHECK_FALSE(snapshot.find("FO").has_value());
+	CHECK_FALSE(snapshot.find("FOOO").has_value());
+	CHECK_FALSE(snapshot.find("").has_value());
+
+	CHECK(snapshot.consume("BAR"));
+	CHECK_FALSE(snapshot.consume("BAR"));
+	CHECK_FALSE(snapshot.consume("UNKNOWN"));
+	CHECK(snapshot.size() == 3);
+	CHECK_FALSE(snapshot.find("BAR").has_value());
+	CHECK(snapshot.find("BAZ") == "baz");
+
+	auto names = std::vector<std::string_view>{};
+	for (const auto& [name, value] : snapshot) {
+		names.push_back(name);
+	}
+	CHECK(names == std::vector<std::string_view>{"FOO", "EMPTY", "BAZ"});
+
+	CHECK(snapshot.consume("FOO"));
+	CHECK(snapshot.consume("EMPTY"));
+	CHECK(snapshot.consume("BAZ"));
+	CHECK(snapshot.empty());
+	CHECK(snapshot.begin() == snapshot.end());
+}
+
+TEST_CASE("Environment snapshot with many entries", "[libenvpp_env]")
+{
+	constexpr auto num_entries = 10'000;
+	auto entries = std::vector<std::pair<std::string, std::string>>{};
+	for (auto i = 0; i < num_entries; ++i) {
+		entries.emplace_back("VAR_" + std::to_string(i), std::to_string(i * 2));
+	}
+
+	const auto snapshot = environment_snapshot(entries);
+	REQUIRE(snapshot.size() == num_entries);
+	for (auto i = 0; i < num_entries; ++i) {
+		CHECK(snapshot.find("VAR_" + std::to_string(i)) == std::to_string(i * 2));
+		CHECK_FALSE(snapshot.find("VAR_" + std::to_string(i) + "_").has_value());
+	}
+	CHECK(std::distance(snapshot.begin(), snapshot.end()) == num_entries);
+}
+
+TEST_CASE("Name pool", "[libenvpp_env]")
+{
+	auto names = name_pool("PREFIX_");
+	CHECK(names.size() == 0);
+	CHECK(names.add("FOO") == 0);
+	CHECK(names.add("") == 1);
+	CHECK(names.add("A_VERY_LONG_NAME_WHICH_DOES_NOT_FIT_INTO_THE_SMALL_STRING_BUFFER") == 2);
+	REQUIRE(names.size() == 3);
+
+	const auto moved_names = std::move(names);
+	CHECK(moved_names.prefix_name() == "PREFIX_");
+	CHECK(moved_names.full_name(0) == "PREFIX_FOO");
+	CHECK(moved_names.name(0) == "FOO");
+	CHECK(moved_names.full_name(1) == "PREFIX_");
+	CHECK(moved_names.name(1) == "");
+	CHECK(moved_names.full_name(2) == "PREFIX_A_VERY_LONG_NAME_WHICH_DOES_NOT_FIT_INTO_THE_SMALL_STRING_BUFFER");
+	CHECK(moved_names.name(2) == "A_VERY_LONG_NAME_WHICH_DOES_NOT_FIT_INTO_THE_SMALL_STRING_BUFFER");
+	for (std::size_t i = 0; i < moved_names.size(); ++i) {
+		CHECK(moved_names.hash(i) == hash_env_var_name(moved_names.full_name(i)));
+	}
+
+	constexpr const char* vars[] = {"PREFIX_FOO=foo", nullptr};
+	auto snapshot = environment_snapshot(environment_view(vars));
+	CHECK(snapshot.find(moved_names.full_name(0), moved_names.hash(0)) == "foo");
+	CHECK_FALSE(snapshot.find(moved_names.full_name(1), moved_names.hash(1)).has_value());
+	CHECK(snapshot.consume(moved_names.full_name(0), moved_names.hash(0)));
+	CHECK_FALSE(snapshot.find(moved_names.full_name(0), moved_names.hash(0)).has_value());
+}
+
+TEST_CASE("Name set", "[libenvpp_env]")
+{
+	auto names = name_set();
+	CHECK(names.empty());
+	CHECK_FALSE(names.contains("FOO", hash_env_var_name("FOO")));
+
+	constexpr auto num_names = 1'000;
+	for (auto i = 0; i < num_names; ++i) {
+		const auto name = "VAR_" + std::to_string(i);
+		names.insert(name, hash_env_var_name(name));
+		names.insert(name, hash_env_var_name(name));
+	}
+	CHECK_FALSE(names.empty());
+	for (auto i = 0; i < num_names; ++i) {
+		const auto name = "VAR_" + std::to_string(i);
+		CHECK(names.contains(name, hash_env_var_name(name)));
+		CHECK_FALSE(names.contains(name + "_", hash_env_var_name(name + "_")));
+	}
+}
+
+TEST_CASE("Layered environment consumption", "[libenvpp_env]")
+{
+	const auto high_precedence_env = std::unordered_map<std::string, std::string>{{"FOO", "high"}, {"BAR", "bar"}};
+	const auto low_precedence_env = std::unordered_map<std::string, std::string>{{"FOO", "low"}, {"BAZ", "baz"}};
+	auto environment = layered_environment(high_precedence_env, low_precedence_env);
+
+	CHECK(environment.find("FOO") == "high");
+	CHECK(environment.find("BAZ") == "baz");
+	CHECK_FALSE(environment.find("UNKNOWN").has_value());
+
+	const auto get_names = [&] {
+		auto names = std::vector<std::string>{};
+		environment.for_each([&](const std::string_view name, const std::string_view) { names.emplace_back(name); });
+		std::sort(names.begin(), names.end());
+		return names;
+	};
+	CHECK(get_names() == std::vector<std::string>{"BAR", "BAZ", "FOO"});
+
+	environment.consume("FOO");
+	environment.consume("BAZ");
+	CHECK_FALSE(environment.find("FOO").has_value());
+	CHECK_FALSE(environment.find("BAZ").has_value());
+	CHECK(get_names() == std::vector<std::string>{"BAR"});
+	CHECK(low_precedence_env.size() == 2);
+}
+
+TEST_CASE("Process-wide environment snapshot", "[libenvpp_env]")
+{
+	constexpr auto test_var_name = "LIBENVPP_TESTING_SNAPSHOT";
+
+	const auto snapshot = get_environment_snapshot();
+	REQUIRE(snapshot != nullptr);
+	CHECK(get_environment_snapshot() == snapshot);
+	CHECK(get_current_environment_snapshot() == snapshot);
+	CHECK_FALSE(snapshot->find(test_var_name).has_value());
+
+	{
+		const auto _ = set_scoped_environment_variable{test_var_name, "snapshot"};
+		CHECK(get_current_environment_snapshot() == nullptr);
+		const auto updated_snapshot = get_environment_snapshot();
+		CHECK(updated_snapshot != snapshot);
+		CHECK(updated_snapshot->find(test_var_name) == "snapshot");
+		CHECK_FALSE(snapshot->find(test_var_name).has_value());
+	}
+
+	CHECK_FALSE(get_environment_snapshot()->find(test_var_name).has_value());
+
+	const auto current_snapshot = get_environment_snapshot();
+	env::refresh_snapshot();
+	CHECK(get_current_environment_snapshot() == nullptr);
+	CHECK(get_environment_snapshot() != current_snapshot);
+}
+
 TEST_CASE("Character encoding for variable names", "[libenvpp_env]")
 {
 	SECTION("Valid input")
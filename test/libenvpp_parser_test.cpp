@@ -1,13 +1,30 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <locale>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
 #include <fmt/format.h>
 
+#include <libenvpp/detail/flat_map.hpp>
+#include <libenvpp/detail/option_table.hpp>
 #include <libenvpp/detail/parser.hpp>
+#include <libenvpp/detail/parser_and_validator_fn.hpp>
+#include <libenvpp/detail/value_arena.hpp>
 
 namespace env::detail {
 
@@ -148,6 +165,17 @@ static_assert(is_stringstream_constructible_v<stream_constructible_3> == true);
 static_assert(is_stringstream_constructible_v<stream_constructible_4> == false);
 static_assert(is_stringstream_constructible_v<stream_constructible_5> == true);
 
+static_assert(is_from_chars_parsable_v<bool> == false);
+static_assert(is_from_chars_parsable_v<char> == false);
+static_assert(is_from_chars_parsable_v<signed char> == false);
+static_assert(is_from_chars_parsable_v<unsigned char> == false);
+static_assert(is_from_chars_parsable_v<short> == true);
+static_assert(is_from_chars_parsable_v<unsigned int> == true);
+static_assert(is_from_chars_parsable_v<long long> == true);
+static_assert(is_from_chars_parsable_v<float> == true);
+static_assert(is_from_chars_parsable_v<double> == true);
+static_assert(is_from_chars_parsable_v<std::string> == false);
+
 //////////////////////////////////////////////////////////////////////////
 
 template <typename T>
@@ -265,6 +293,269 @@ TEST_CASE("Parsing well-formed input of built-in type", "[libenvpp_parser]")
 	}
 }
 
+TEST_CASE("Parsing borrowed string types", "[libenvpp_parser]")
+{
+	static_assert(is_borrowed_string_v<std::string_view>);
+	static_assert(!is_borrowed_string_v<std::string>);
+
+	const auto str = std::string_view(" foo bar ");
+	const auto view = construct_from_string<std::string_view>(str);
+	CHECK(view.data() == str.data());
+	CHECK(view.size() == str.size());
+
+#if defined(__cpp_lib_span)
+	static_assert(is_borrowed_string_v<std::span<const char>>);
+	const auto span = construct_from_string<std::span<const char>>(str);
+	CHECK(span.data() == str.data());
+	CHECK(span.size() == str.size());
+#endif
+}
+
+TEST_CASE("Parsing delimited containers", "[libenvpp_parser]")
+{
+	static_assert(delimiter_depth_v<int> == 0);
+	static_assert(delimiter_depth_v<std::vector<int>> == 1);
+	static_assert(delimiter_depth_v<std::vector<std::pair<std::string, std::set<int>>>> == 3);
+	static_assert(default_delimiters_v<std::vector<std::pair<std::string, std::set<int>>>> == ",:;");
+	static_assert(default_delimiters_v<std::pair<std::string, std::vector<int>>> == ":,");
+	static_assert(default_delimiters_v<std::vector<std::vector<int>>> == ",:");
+
+	SECTION("Well-formed input")
+	{
+		CHECK(construct_from_string<std::vector<int>>("0,2,4,6") == std::vector<int>{0, 2, 4, 6});
+		CHECK(construct_from_string<std::vector<int>>("").empty());
+		CHECK(construct_from_string<std::vector<std::string>>(",a,") == std::vector<std::string>{"", "a", ""});
+		CHECK(construct_from_string<std::set<int>>("3,1,2") == std::set<int>{1, 2, 3});
+		CHECK(construct_from_string<std::unordered_set<int>>("3,1,2") == std::unordered_set<int>{1, 2, 3});
+		CHECK(construct_from_string<std::array<double, 3>>("1.5,2,-3") == std::array<double, 3>{1.5, 2.0, -3.0});
+		CHECK(construct_from_string<std::array<int, 0>>("").empty());
+		CHECK(construct_from_string<std::pair<std::string, int>>("localhost:8080")
+		      == std::pair<std::string, int>{"localhost", 8080});
+		CHECK(construct_from_string<std::pair<std::string, std::string>>("a:b:c")
+		      == std::pair<std::string, std::string>{"a", "b:c"});
+		CHECK(construct_from_string<std::vector<std::pair<std::string, int>>>("a:1,b:2,c:3")
+		      == std::vector<std::pair<std::string, int>>{{"a", 1}, {"b", 2}, {"c", 3}});
+		CHECK(construct_from_string<std::vector<std::vector<int>>>("1:2,,3")
+		      == std::vector<std::vector<int>>{{1, 2}, {}, {3}});
+	}
+
+	SECTION("Custom delimiters")
+	{
+		CHECK(delimited_parser_and_validator<std::vector<int>>(' ')("1 2 3") == std::vector<int>{1, 2, 3});
+		CHECK(delimited_parser_and_validator<std::vector<std::pair<std::string, int>>>(";=")("a=1;b=2")
+		      == std::vector<std::pair<std::string, int>>{{"a", 1}, {"b", 2}});
+		using pairs_parser = delimited_parser_and_validator<std::vector<std::pair<int, int>>>;
+		CHECK_THROWS_AS(pairs_parser(";"), invalid_delimiters);
+		CHECK_THROWS_AS(pairs_parser(";;"), invalid_delimiters);
+	}
+
+	SECTION("Errors report the element index")
+	{
+		CHECK_THROWS_AS(construct_from_string<std::vector<int>>("1,x,3"), parser_error);
+		CHECK_THROWS_WITH(construct_from_string<std::vector<int>>("1,x,3"), ContainsSubstring("Element 1 'x'"));
+		using pairs_t = std::vector<std::pair<std::string, int>>;
+		CHECK_THROWS_WITH(construct_from_string<pairs_t>("a:1,b:2,c:x"),
+		                  ContainsSubstring("Element 2 'c:x': Element 1 'x'"));
+		using array_t = std::array<int, 2>;
+		CHECK_THROWS_WITH(construct_from_string<array_t>("1,2,3"), ContainsSubstring("Expected 2 elements, but got 3"));
+		using pair_t = std::pair<int, int>;
+		CHECK_THROWS_WITH(construct_from_string<pair_t>("1"),
+		                  ContainsSubstring("Expected two elements separated by ':'"));
+		CHECK_THROWS_WITH(construct_from_string<std::set<int>>("3,1,2,1"),
+		                  ContainsSubstring("Element 3 '1': Duplicate element"));
+		CHECK_THROWS_WITH(construct_from_string<std::unordered_set<std::string>>("a,a"),
+		                  ContainsSubstring("Element 1 'a': Duplicate element"));
+	}
+}
+
+TEST_CASE("Parsing delimited maps", "[libenvpp_parser]")
+{
+	using map_t = std::map<std::string, std::string>;
+	using unordered_map_t = std::unordered_map<std::string, int>;
+	using flat_map_t = flat_map<std::string, int>;
+	static_assert(delimiter_depth_v<map_t> == 2);
+	static_assert(default_delimiters_v<map_t> == ",=");
+	static_assert(default_delimiters_v<std::map<std::string, std::vector<int>>> == ",=:");
+
+	SECTION("Well-formed input")
+	{
+		CHECK(construct_from_string<map_t>("zone=a,tier=hot") == map_t{{"zone", "a"}, {"tier", "hot"}});
+		CHECK(construct_from_string<map_t>("").empty());
+		CHECK(construct_from_string<map_t>("url=a=b,empty=") == map_t{{"url", "a=b"}, {"empty", ""}});
+		CHECK(construct_from_string<unordered_map_t>("a=1,b=2") == unordered_map_t{{"a", 1}, {"b", 2}});
+		CHECK(construct_from_string<flat_map_t>("c=3,a=1,b=2") == flat_map_t{{"a", 1}, {"b", 2}, {"c", 3}});
+		CHECK(construct_from_string<std::map<int, std::vector<int>>>("1=1:2,2=")
+		      == std::map<int, std::vector<int>>{{1, {1, 2}}, {2, {}}});
+		CHECK(delimited_parser_and_validator<map_t>(";:")("a:1;b:2") == map_t{{"a", "1"}, {"b", "2"}});
+	}
+
+	SECTION("Errors report the element index")
+	{
+		CHECK_THROWS_WITH(construct_from_string<map_t>("a=1,b"),
+		                  ContainsSubstring("Element 1 'b': Expected two elements separated by '='"));
+		CHECK_THROWS_WITH(construct_from_string<unordered_map_t>("a=1,b=x"),
+		                  ContainsSubstring("Element 1 'b=x': Element 1 'x'"));
+		CHECK_THROWS_WITH(construct_from_string<map_t>("a=1,b=2,a=3"),
+		                  ContainsSubstring("Element 2 'a=3': Duplicate key 'a'"));
+		CHECK_THROWS_WITH(construct_from_string<unordered_map_t>("a=1,a=1"),
+		                  ContainsSubstring("Element 1 'a=1': Duplicate key 'a'"));
+		CHECK_THROWS_WITH(construct_from_string<flat_map_t>("b=1,a=2,b=3"),
+		                  ContainsSubstring("Element 2 'b=3': Duplicate key 'b'"));
+	}
+}
+
+TEST_CASE("Flat map", "[libenvpp_parser]")
+{
+	auto map = flat_map<std::string, int>{};
+	CHECK(map.empty());
+	CHECK(map.insert({"b", 2}).second);
+	CHECK(map.emplace("c", 3).second);
+	CHECK(map.emplace("a", 1).second);
+	const auto [it, inserted] = map.emplace("b", 4);
+	CHECK_FALSE(inserted);
+	CHECK(it->second == 2);
+
+	REQUIRE(map.size() == 3);
+	auto keys = std::vector<std::string>{};
+	for (const auto& [key, value] : map) {
+		keys.push_back(key);
+	}
+	CHECK(keys == std::vector<std::string>{"a", "b", "c"});
+	CHECK(map.contains("a"));
+	CHECK_FALSE(map.contains("d"));
+	CHECK(map.count("c") == 1);
+	CHECK(map.at("c") == 3);
+	CHECK(map.find("d") == map.end());
+	CHECK_THROWS_AS(map.at("d"), std::out_of_range);
+}
+
+TEST_CASE("Parsing durations and byte sizes", "[libenvpp_parser]")
+{
+	using namespace std::chrono_literals;
+
+	SECTION("Durations")
+	{
+		CHECK(construct_from_string<std::chrono::milliseconds>("250ms") == 250ms);
+		CHECK(construct_from_string<std::chrono::seconds>("1h30m") == 5400s);
+		CHECK(construct_from_string<std::chrono::milliseconds>(" 1h 30m 5s ") == 5405s);
+		CHECK(construct_from_string<std::chrono::nanoseconds>("1us") == 1000ns);
+		CHECK(construct_from_string<std::chrono::microseconds>("2s500ms") == 2500ms);
+		CHECK(construct_from_string<std::chrono::minutes>("2h") == 120min);
+		CHECK(construct_from_string<std::chrono::seconds>("-1m") == -60s);
+		CHECK(construct_from_string<std::chrono::seconds>("0") == 0s);
+		CHECK(construct_from_string<std::chrono::duration<double>>("1500ms").count() == 1.5);
+
+		CHECK_THROWS_WITH(construct_from_string<std::chrono::seconds>("5"), ContainsSubstring("Missing unit"));
+		CHECK_THROWS_WITH(construct_from_string<std::chrono::seconds>("5x"), ContainsSubstring("Unknown unit 'x'"));
+		CHECK_THROWS_WITH(construct_from_string<std::chrono::seconds>("1500ms"),
+		                  ContainsSubstring("cannot be represented exactly"));
+		CHECK_THROWS_WITH(construct_from_string<std::chrono::nanoseconds>("9999999999h"),
+		                  ContainsSubstring("out of range"));
+		CHECK_THROWS_WITH(construct_from_string<std::chrono::nanoseconds>("5000000000s5000000000s"),
+		                  ContainsSubstring("out of range"));
+		CHECK_THROWS_AS(construct_from_string<std::chrono::seconds>(""), parser_error);
+		CHECK_THROWS_AS(construct_from_string<std::chrono::seconds>("s"), parser_error);
+		CHECK_THROWS_AS(construct_from_string<std::chrono::seconds>("1.5s"), parser_error);
+	}
+
+	SECTION("Byte sizes")
+	{
+		CHECK(construct_from_string<byte_size>("4096") == byte_size(4096));
+		CHECK(construct_from_string<byte_size>("16B") == byte_size(16));
+		CHECK(construct_from_string<byte_size>("2KB") == byte_size(2000));
+		CHECK(construct_from_string<byte_size>("2KiB") == kibibytes(2));
+		CHECK(construct_from_string<byte_size>("512MiB") == mebibytes(512));
+		CHECK(construct_from_string<byte_size>("1 GiB") == gibibytes(1));
+		CHECK(construct_from_string<byte_size>("3TB").count() == 3'000'000'000'000);
+
+		CHECK_THROWS_WITH(construct_from_string<byte_size>("1PB"), ContainsSubstring("Unknown unit 'PB'"));
+		CHECK_THROWS_WITH(construct_from_string<byte_size>("99999999999TiB"), ContainsSubstring("out of range"));
+		CHECK_THROWS_AS(construct_from_string<byte_size>("1KiB2"), parser_error);
+		CHECK_THROWS_AS(construct_from_string<byte_size>("-1B"), parser_error);
+		CHECK(fmt::format("{}", kibibytes(1)) == "1024B");
+	}
+}
+
+TEST_CASE("Parsing binary data", "[libenvpp_parser]")
+{
+	const auto to_bytes = [](const std::string_view str) {
+		auto value = env::bytes{};
+		for (const auto c : str) {
+			value.push_back(static_cast<std::byte>(c));
+		}
+		return value;
+	};
+	const auto parse = [](const std::string_view str, const bytes_encoding encoding) {
+		return bytes_parser_and_validator{encoding}(str);
+	};
+
+	SECTION("Base64")
+	{
+		CHECK(construct_from_string<env::bytes>("").empty());
+		CHECK(construct_from_string<env::bytes>("TWFu") == to_bytes("Man"));
+		CHECK(construct_from_string<env::bytes>("TWE=") == to_bytes("Ma"));
+		CHECK(construct_from_string<env::bytes>("TWE") == to_bytes("Ma"));
+		CHECK(construct_from_string<env::bytes>("TQ==") == to_bytes("M"));
+		CHECK(construct_from_string<env::bytes>(" TQ \n") == to_bytes("M"));
+		CHECK(construct_from_string<env::bytes>("+/+/")
+		      == env::bytes{std::byte{0xFB}, std::byte{0xFF}, std::byte{0xBF}});
+
+		auto encoded = std::string{};
+		auto decoded = std::string{};
+		for (auto i = 0; i < 40; ++i) {
+			encoded += "QUJD";
+			decoded += "ABC";
+		}
+		CHECK(construct_from_string<env::bytes>(encoded + "RA==") == to_bytes(decoded + "D"));
+
+		CHECK_THROWS_WITH(construct_from_string<env::bytes>("TW-u"),
+		                  ContainsSubstring("Invalid base64 character '-' at position 2"));
+		CHECK_THROWS_WITH(construct_from_string<env::bytes>(encoded + "QU*D"),
+		                  ContainsSubstring("Invalid base64 character '*' at position 162"));
+		CHECK_THROWS_WITH(construct_from_string<env::bytes>("TWFuT"), ContainsSubstring("the length is invalid"));
+		CHECK_THROWS_WITH(construct_from_string<env::bytes>("TWE=="), ContainsSubstring("the length is invalid"));
+		CHECK_THROWS_WITH(construct_from_string<env::bytes>("TQ="), ContainsSubstring("the length is invalid"));
+		CHECK_THROWS_WITH(construct_from_string<env::bytes>("TWF="), ContainsSubstring("the unused bits are not zero"));
+		CHECK_THROWS_WITH(construct_from_string<env::bytes>("TR=="), ContainsSubstring("the unused bits are not zero"));
+		CHECK_THROWS_WITH(construct_from_string<env::bytes>(encoded + "RB"),
+		                  ContainsSubstring("the unused bits are not zero"));
+		CHECK_THROWS_AS(construct_from_string<env::bytes>("TQ=A"), parser_error);
+		CHECK_THROWS_AS(construct_from_string<env::bytes>("===="), parser_error);
+		CHECK_THROWS_AS(construct_from_string<env::bytes>("TW Fu"), parser_error);
+	}
+
+	SECTION("Base64url")
+	{
+		CHECK(parse("-_-_", bytes_encoding::base64url)
+		      == env::bytes{std::byte{0xFB}, std::byte{0xFF}, std::byte{0xBF}});
+		CHECK(parse("TWE", bytes_encoding::base64url) == to_bytes("Ma"));
+		CHECK(parse("TWE=", bytes_encoding::base64url) == to_bytes("Ma"));
+		CHECK_THROWS_WITH(parse("+/+/", bytes_encoding::base64url),
+		                  ContainsSubstring("Invalid base64url character '+' at position 0"));
+	}
+
+	SECTION("Hex")
+	{
+		CHECK(parse("", bytes_encoding::hex).empty());
+		CHECK(parse("4d616e", bytes_encoding::hex) == to_bytes("Man"));
+		CHECK(parse(" 4D616E ", bytes_encoding::hex) == to_bytes("Man"));
+
+		auto encoded = std::string{};
+		auto decoded = env::bytes{};
+		for (auto i = 0; i < 256; ++i) {
+			encoded += fmt::format(i % 2 == 0 ? "{:02x}" : "{:02X}", i);
+			decoded.push_back(static_cast<std::byte>(i));
+		}
+		CHECK(parse(encoded, bytes_encoding::hex) == decoded);
+
+		CHECK_THROWS_WITH(parse("4d61 6e", bytes_encoding::hex), ContainsSubstring("number of digits must be even"));
+		CHECK_THROWS_WITH(parse("4d6g6e", bytes_encoding::hex),
+		                  ContainsSubstring("Invalid hex character 'g' at position 3"));
+		CHECK_THROWS_WITH(parse(encoded + "0x", bytes_encoding::hex),
+		                  ContainsSubstring("Invalid hex character 'x' at position 513"));
+	}
+}
+
 TEST_CASE("Parsing well-formed input of user-defined type", "[libenvpp_parser]")
 {
 	test_parser<string_constructible_6>("", string_constructible_6{""});
@@ -399,4 +690,351 @@ TEST_CASE("Parsing ill-formed input of user-defined type", "[libenvpp_parser]")
 	test_parser_error<not_stream_constructible_3>("not_stream_constructible_3");
 }
 
+//////////////////////////////////////////////////////////////////////////
+
+// Reference implementation using operator>>, as arithmetic types were parsed before std::from_chars was used.
+template <typename T>
+static std::optional<T> stream_parse(const std::string_view str)
+{
+	auto stream = std::istringstream(std::string(str));
+	auto parsed = T();
+	if constexpr (std::is_same_v<T, bool>) {
+		stream >> parsed;
+		if (stream.fail()) {
+			stream = std::istringstream(std::string(str));
+			auto bool_str = std::string();
+			stream >> bool_str;
+			const auto value = match_bool(bool_str);
+			if (!value.has_value()) {
+				return std::nullopt;
+			}
+			parsed = *value;
+		}
+	} else {
+		stream >> parsed;
+	}
+	if (!stream.eof()) {
+		stream >> std::ws;
+	}
+	if (stream.fail() || static_cast<std::size_t>(stream.tellg()) < str.size()) {
+		return std::nullopt;
+	}
+	if constexpr (!std::is_same_v<T, bool> && std::is_unsigned_v<T>) {
+		auto signed_parsed = std::int64_t{};
+		auto signed_stream = std::istringstream(std::string(str));
+		signed_stream >> signed_parsed;
+		if (signed_parsed < 0) {
+			return std::nullopt;
+		}
+	}
+	return parsed;
+}
+
+template <typename T>
+static void test_parser_against_stream(const std::string_view str)
+{
+	const auto expected = stream_parse<T>(str);
+	if (expected.has_value()) {
+		CHECK_NOTHROW([&] {
+			const auto parsed = construct_from_string<T>(str);
+			CHECK(parsed == *expected);
+		}());
+	} else {
+		CHECK_THROWS_AS(construct_from_string<T>(str), parser_error);
+	}
+}
+
+TEST_CASE("Parsing primitive types matches stream operator", "[libenvpp_parser]")
+{
+	constexpr const char* number_inputs[] = {"0", "1", "-1", "+1", "-0", "+0", "00042", "-00", "+-1", "-+1", "--1",
+	    "++1", "-", "+", "", " ", " \t\r\n", " 42 ", "\t-7\n", "4 2", "42 x", "x42", "0x10", "1e3", "1.5", ".5", "-.5",
+	    "+.5", "1.", ".", "1e", "1e+2", "1E-2", "-1.5e3", "inf", "-inf", "nan", "infinity", "127", "128", "-128",
+	    "-129", "255", "256", "32767", "32768", "-32768", "-32769", "65535", "65536", "-65535", "3.1415", "0.1",
+	    "123456789.1", "1,5", "2147483647", "2147483648", "-2147483648", "-2147483649", "4294967295", "4294967296",
+	    "-4294967295", "9223372036854775807", "-9223372036854775808", "1e38", "-1e-38", "1e-50", "1e-330", "1e39",
+	    "1e308", "1.7976931348623157e308"};
+
+	for (const auto* input : number_inputs) {
+		CAPTURE(input);
+		test_parser_against_stream<short>(input);
+		test_parser_against_stream<unsigned short>(input);
+		test_parser_against_stream<int>(input);
+		test_parser_against_stream<unsigned int>(input);
+		test_parser_against_stream<long>(input);
+		test_parser_against_stream<unsigned long>(input);
+		test_parser_against_stream<long long>(input);
+		test_parser_against_stream<unsigned long long>(input);
+		test_parser_against_stream<float>(input);
+		test_parser_against_stream<double>(input);
+	}
+
+	constexpr const char* bool_inputs[] = {"0", "1", "00", "01", "+1", "-0", "-1", "2", "10", "true", "TRUE", "tRuE",
+	    "yes", "No", "on", "OFF", "false", " yes ", "\ton\n", "yes no", "truee", "tru", "y", "", " ", "1 ", " 0", "1x",
+	    "o", "@n", "0n", "fa1se", "+true", "-", "+", "1.0"};
+
+	for (const auto* input : bool_inputs) {
+		CAPTURE(input);
+		test_parser_against_stream<bool>(input);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+struct comma_decimal_point : std::numpunct<char> {
+	char do_decimal_point() const override { return ','; }
+};
+
+struct stream_decimal {
+	double value;
+};
+
+std::istringstream& operator>>(std::istringstream& stream, stream_decimal& decimal)
+{
+	stream >> decimal.value;
+	return stream;
+}
+
+class scoped_global_locale {
+  public:
+	scoped_global_locale(const std::locale& locale) : m_old_locale(std::locale::global(locale)) {}
+	~scoped_global_locale() { std::locale::global(m_old_locale); }
+
+  private:
+	std::locale m_old_locale;
+};
+
+TEST_CASE("Parsing with global locale", "[libenvpp_parser]")
+{
+	const auto _ = scoped_global_locale(std::locale(std::locale::classic(), new comma_decimal_point));
+
+	CHECK(construct_from_string<double>("1.5") == 1.5);
+	CHECK(construct_from_string<float>(" -2.25 ") == -2.25f);
+	CHECK(construct_from_string<int>("42") == 42);
+	test_parser_error<double>("1,5");
+
+#if LIBENVPP_CLASSIC_LOCALE
+	CHECK(construct_from_string<stream_decimal>("1.5").value == 1.5);
+	test_parser_error<stream_decimal>("1,5");
+#else
+	CHECK(construct_from_string<stream_decimal>("1,5").value == 1.5);
+	test_parser_error<stream_decimal>("1.5");
+#endif
+}
+
+TEST_CASE("Classic locale stream is reset between uses", "[libenvpp_parser]")
+{
+	const auto hex_value = with_classic_locale_stream("ff", [](std::istringstream& stream) {
+		auto value = 0;
+		stream >> std::hex >> value;
+		return value;
+	});
+	CHECK(hex_value == 255);
+
+	const auto read_int = [](std::istringstream& stream) {
+		auto value = 0;
+		stream >> value;
+		return value;
+	};
+
+	const auto nested_value = with_classic_locale_stream("10", [&](std::istringstream& stream) {
+		const auto value = read_int(stream);
+		return value + with_classic_locale_stream("20", read_int);
+	});
+	CHECK(nested_value == 30);
+
+	CHECK(with_classic_locale_stream("10", read_int) == 10);
+}
+
+TEST_CASE("Stream is reset after a custom operator>> changed it", "[libenvpp_parser]")
+{
+	with_input_stream("", [](std::istringstream& stream) {
+		stream.imbue(std::locale(std::locale::classic(), new comma_decimal_point));
+		stream.exceptions(std::ios_base::failbit);
+	});
+
+	// Neither the locale nor the exception mask set by the previous operator>> are still in effect.
+	CHECK(construct_from_string<stream_decimal>("1.5").value == 1.5);
+	CHECK_THROWS_WITH(construct_from_string<stream_decimal>("abc"),
+	                  ContainsSubstring("Stream operator>> failed for input 'abc'") && !ContainsSubstring(" with "));
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+[[nodiscard]] T invoke_parser_and_validator(parser_and_validator_fn& fn, const std::string_view str)
+{
+	auto values = value_arena{};
+	const auto slot = values.add_slot(&value_type_info_v<T>);
+	values.allocate();
+	fn(str, values.get_storage(slot));
+	values.set_constructed(slot);
+	return values.get<T>(slot);
+}
+
+TEST_CASE("Type-erased parser and validator", "[libenvpp_parser]")
+{
+	auto options = option_table<int>({1, 2, 3}, {"ONE", "TWO", "THREE"});
+	auto option_parser = [options](const std::string_view) { return *options.find("ONE"); };
+	static_assert(parser_and_validator_fn::is_stored_inline<decltype(option_parser)>);
+
+	auto large_data = std::array<char, 256>{'4', '2'};
+	auto large_parser = [large_data](const std::string_view) { return std::string(large_data.data()); };
+	static_assert(!parser_and_validator_fn::is_stored_inline<decltype(large_parser)>);
+
+	SECTION("Value is converted to registered type")
+	{
+		auto fn = parser_and_validator_fn(std::in_place_type<long long>, [](const std::string_view str) {
+			return construct_from_string<int>(str);
+		});
+		CHECK(invoke_parser_and_validator<long long>(fn, "42") == 42);
+	}
+
+	SECTION("Inline and heap storage")
+	{
+		auto inline_fn = parser_and_validator_fn(std::in_place_type<int>, option_parser);
+		auto heap_fn = parser_and_validator_fn(std::in_place_type<std::string>, large_parser);
+		CHECK(invoke_parser_and_validator<int>(inline_fn, "") == 1);
+		CHECK(invoke_parser_and_validator<std::string>(heap_fn, "") == "42");
+
+		auto moved_inline_fn = std::move(inline_fn);
+		auto moved_heap_fn = std::move(heap_fn);
+		CHECK_FALSE(inline_fn);
+		CHECK_FALSE(heap_fn);
+		CHECK(invoke_parser_and_validator<int>(moved_inline_fn, "") == 1);
+		CHECK(invoke_parser_and_validator<std::string>(moved_heap_fn, "") == "42");
+	}
+
+	SECTION("Callables are destroyed")
+	{
+		const auto counter = std::make_shared<int>(0);
+		{
+			auto fn = parser_and_validator_fn(std::in_place_type<int>, [counter](const std::string_view) { return 0; });
+			CHECK(counter.use_count() == 2);
+			auto moved_fn = std::move(fn);
+			CHECK(counter.use_count() == 2);
+			moved_fn = parser_and_validator_fn(std::in_place_type<int>, [](const std::string_view) { return 1; });
+			CHECK(counter.use_count() == 1);
+			CHECK(invoke_parser_and_validator<int>(moved_fn, "") == 1);
+		}
+		CHECK(counter.use_count() == 1);
+	}
+
+	SECTION("Exceptions are propagated")
+	{
+		auto fn = parser_and_validator_fn(std::in_place_type<int>, [](const std::string_view str) -> int {
+			throw parser_error{fmt::format("Failed to parse '{}'", str)};
+		});
+		auto value = int{};
+		CHECK_THROWS_AS(fn("foo", &value), parser_error);
+	}
+
+	SECTION("Void parser and validator does not construct a value")
+	{
+		auto calls = 0;
+		auto fn = parser_and_validator_fn(std::in_place_type<void>, [&calls](const std::string_view) { ++calls; });
+		fn("", nullptr);
+		CHECK(calls == 1);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+TEST_CASE("Value arena", "[libenvpp_parser]")
+{
+	auto values = value_arena{};
+	const auto char_slot = values.add_slot(&value_type_info_v<char>);
+	const auto empty_slot = values.add_slot(nullptr);
+	const auto double_slot = values.add_slot(&value_type_info_v<double>);
+	const auto string_slot = values.add_slot(&value_type_info_v<std::string>);
+
+	CHECK_FALSE(values.has_value(char_slot));
+	CHECK_FALSE(values.has_value(empty_slot));
+	CHECK_FALSE(values.has_value(double_slot));
+	CHECK_FALSE(values.has_value(string_slot));
+
+	SECTION("Values are stored aligned")
+	{
+		values.emplace<char>(char_slot, 'a');
+		values.emplace<double>(double_slot, 4.2);
+		values.emplace<std::string>(string_slot, "foo");
+		CHECK(values.get<char>(char_slot) == 'a');
+		CHECK(values.get<double>(double_slot) == 4.2);
+		CHECK(values.get<std::string>(string_slot) == "foo");
+		CHECK(reinterpret_cast<std::uintptr_t>(&values.get<double>(double_slot)) % alignof(double) == 0);
+		CHECK(reinterpret_cast<std::uintptr_t>(&values.get<std::string>(string_slot)) % alignof(std::string) == 0);
+		CHECK_FALSE(values.has_value(empty_slot));
+	}
+
+	SECTION("Values are relocated when adding slots")
+	{
+		values.emplace<std::string>(string_slot, std::string(100, 'x'));
+		const auto int_slot = values.add_slot(&value_type_info_v<int>);
+		values.allocate();
+		CHECK(values.get<std::string>(string_slot) == std::string(100, 'x'));
+		CHECK_FALSE(values.has_value(int_slot));
+		values.emplace<int>(int_slot, 42);
+		CHECK(values.get<int>(int_slot) == 42);
+	}
+
+	SECTION("Values are destroyed")
+	{
+		const auto counter = std::make_shared<int>(0);
+		{
+			auto other_values = value_arena{};
+			const auto slot = other_values.add_slot(&value_type_info_v<std::shared_ptr<int>>);
+			other_values.emplace<std::shared_ptr<int>>(slot, counter);
+			CHECK(counter.use_count() == 2);
+			other_values.emplace<std::shared_ptr<int>>(slot, counter);
+			CHECK(counter.use_count() == 2);
+			auto moved_values = std::move(other_values);
+			CHECK(counter.use_count() == 2);
+			moved_values.reset(slot);
+			CHECK_FALSE(moved_values.has_value(slot));
+			CHECK(counter.use_count() == 1);
+			moved_values.emplace<std::shared_ptr<int>>(slot, counter);
+		}
+		CHECK(counter.use_count() == 1);
+	}
+}
+
+TEST_CASE("Option table", "[libenvpp_parser]")
+{
+	auto options = std::vector<int>{};
+	auto option_strings = std::vector<std::string>{};
+	for (int i = 0; i < 500; ++i) {
+		options.push_back((i * 7919) % 500);
+		option_strings.push_back(fmt::format("OPTION_{}", options.back()));
+	}
+	const auto table = option_table<int>(options, option_strings);
+
+	CHECK_FALSE(table.empty());
+	CHECK_FALSE(table.has_duplicates());
+	CHECK(table.option_strings() == std::vector<std::string_view>(option_strings.begin(), option_strings.end()));
+	for (std::size_t i = 0; i < options.size(); ++i) {
+		CHECK(table.contains(options[i]));
+		const auto* const value = table.find(option_strings[i]);
+		REQUIRE(value != nullptr);
+		CHECK(*value == options[i]);
+	}
+	CHECK_FALSE(table.contains(-1));
+	CHECK_FALSE(table.contains(500));
+	CHECK(table.find("OPTION_") == nullptr);
+	CHECK(table.find("OPTION_5000") == nullptr);
+	CHECK(table.find("") == nullptr);
+
+	SECTION("Duplicate options")
+	{
+		CHECK(option_table<int>({3, 1, 2, 1}).has_duplicates());
+		CHECK(option_table<std::string>({"b", "a", "b"}).has_duplicates());
+	}
+
+	SECTION("First of duplicate option strings is found")
+	{
+		const auto duplicate_strings = option_table<int>({1, 2, 3}, {"B", "A", "B"});
+		REQUIRE(duplicate_strings.find("B") != nullptr);
+		CHECK(*duplicate_strings.find("B") == 1);
+		CHECK(*duplicate_strings.find("A") == 2);
+	}
+}
+
 } // namespace env::detail
@@ -1,6 +1,18 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <functional>
 #include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
@@ -93,6 +105,25 @@ TEST_CASE_METHOD(int_var_fixture, "Retrieving integer environment variable", "[l
 	CHECK(*int_val == 42);
 }
 
+TEST_CASE_METHOD(int_var_fixture, "Parsing with an up-to-date process-wide snapshot", "[libenvpp]")
+{
+	const auto unused_var = detail::set_scoped_environment_variable("LIBENVPP_TESTING_UNUSED", "1");
+	const auto snapshot = detail::get_environment_snapshot();
+	REQUIRE(detail::get_current_environment_snapshot() == snapshot);
+
+	for (auto i = 0; i < 2; ++i) {
+		auto pre = env::prefix("LIBENVPP_TESTING");
+		const auto int_id = pre.register_variable<int>("INT");
+		const auto parsed_and_validated_pre = pre.parse_and_validate();
+		REQUIRE(parsed_and_validated_pre.errors().empty());
+		CHECK(parsed_and_validated_pre.get(int_id) == 42);
+		CHECK_THAT(parsed_and_validated_pre.warning_message(),
+		           ContainsSubstring("'LIBENVPP_TESTING_UNUSED' specified but unused"));
+	}
+	// Variables are consumed in a snapshot of the prefix, leaving the shared snapshot untouched.
+	CHECK(snapshot->find("LIBENVPP_TESTING_INT") == "42");
+}
+
 TEST_CASE_METHOD(float_var_fixture, "Retrieving float environment variable", "[libenvpp]")
 {
 	auto pre = env::prefix("LIBENVPP_TESTING");
@@ -115,6 +146,32 @@ TEST_CASE_METHOD(string_var_fixture, "Retrieving string environment variable", "
 	CHECK_THAT(*string_val, Equals("Hello World"));
 }
 
+TEST_CASE_METHOD(string_var_fixture, "Retrieving environment variables by reference", "[libenvpp]")
+{
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	const auto string_id = pre.register_variable<std::string>("STRING");
+	const auto required_string_id = pre.register_required_variable<std::string>("STRING_REQUIRED");
+	const auto unset_id = pre.register_variable<std::string>("UNSET");
+	pre.set_for_testing(required_string_id, "Hello Required");
+	auto parsed_and_validated_pre = pre.parse_and_validate();
+	REQUIRE(parsed_and_validated_pre.ok());
+
+	static_assert(std::is_same_v<decltype(parsed_and_validated_pre.get_ref(required_string_id)), const std::string&>);
+	static_assert(std::is_same_v<decltype(parsed_and_validated_pre.get_ref(string_id)),
+	                             std::optional<std::reference_wrapper<const std::string>>>);
+
+	const auto string_ref = parsed_and_validated_pre.get_ref(string_id);
+	REQUIRE(string_ref.has_value());
+	CHECK_THAT(string_ref->get(), Equals("Hello World"));
+	CHECK(&string_ref->get() == &parsed_and_validated_pre.get_ref(string_id)->get());
+
+	const auto& required_string_ref = parsed_and_validated_pre.get_ref(required_string_id);
+	CHECK_THAT(required_string_ref, Equals("Hello Required"));
+	CHECK(&required_string_ref == &parsed_and_validated_pre.get_ref(required_string_id));
+
+	CHECK_FALSE(parsed_and_validated_pre.get_ref(unset_id).has_value());
+}
+
 TEST_CASE_METHOD(option_var_fixture, "Retrieving option environment variable", "[libenvpp]")
 {
 	auto pre = env::prefix("LIBENVPP_TESTING");
@@ -131,6 +188,65 @@ TEST_CASE_METHOD(option_var_fixture, "Retrieving option environment variable", "
 	CHECK(*simple_option_val == testing_simple_option::OPT_A);
 }
 
+enum class testing_traits_option {
+	FAST,
+	SAFE,
+	DEBUG,
+	UNLISTED,
+};
+
+template <>
+struct option_traits<testing_traits_option> {
+	static constexpr auto options = std::array{
+	    std::pair{std::string_view("safe"), testing_traits_option::SAFE},
+	    std::pair{std::string_view("fast"), testing_traits_option::FAST},
+	    std::pair{std::string_view("debug"), testing_traits_option::DEBUG},
+	};
+};
+
+TEST_CASE("Option environment variables with option traits", "[libenvpp]")
+{
+	using option_t = std::pair<std::string_view, int>;
+	constexpr auto duplicate_names = std::array{option_t{"b", 1}, option_t{"a", 2}, option_t{"b", 3}};
+	constexpr auto duplicate_values = std::array{option_t{"b", 1}, option_t{"a", 2}, option_t{"c", 1}};
+	constexpr auto sorted_indices = detail::sort_options_by_name(duplicate_values);
+	static_assert(sorted_indices[0] == 1 && sorted_indices[1] == 0 && sorted_indices[2] == 2);
+	static_assert(detail::has_duplicate_option_names(duplicate_names, detail::sort_options_by_name(duplicate_names)));
+	static_assert(!detail::has_duplicate_option_values(duplicate_names));
+	static_assert(!detail::has_duplicate_option_names(duplicate_values, sorted_indices));
+	static_assert(detail::has_duplicate_option_values(duplicate_values));
+	static_assert(detail::has_option_traits_v<testing_traits_option>);
+	static_assert(!detail::has_option_traits_v<testing_option>);
+
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	const auto option_id = pre.register_option<testing_traits_option>("MODE");
+	const auto required_option_id = pre.register_required_option<testing_traits_option>("REQUIRED_MODE");
+
+	SECTION("Valid options")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate({
+		    {"LIBENVPP_TESTING_MODE", "debug"},
+		    {"LIBENVPP_TESTING_REQUIRED_MODE", "safe"},
+		});
+		REQUIRE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(option_id) == testing_traits_option::DEBUG);
+		CHECK(parsed_and_validated_pre.get(required_option_id) == testing_traits_option::SAFE);
+	}
+
+	SECTION("Invalid options")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate({
+		    {"LIBENVPP_TESTING_MODE", "UNLISTED"},
+		    {"LIBENVPP_TESTING_REQUIRED_MODE", "Fast"},
+		});
+		REQUIRE(parsed_and_validated_pre.errors().size() == 2);
+		CHECK_THAT(parsed_and_validated_pre.error_message(),
+		           ContainsSubstring("'LIBENVPP_TESTING_MODE': Unrecognized option 'UNLISTED', should be one of "
+		                             "[safe, fast, debug]")
+		               && ContainsSubstring("'LIBENVPP_TESTING_REQUIRED_MODE': Unrecognized option 'Fast'"));
+	}
+}
+
 TEST_CASE("Parsing failure with 'simple' option handling", "[libenvpp]")
 {
 	const auto _ = detail::set_scoped_environment_variable{"LIBENVPP_TESTING_SIMPLE_OPTION", "INVALID_OPTION"};
@@ -272,6 +388,155 @@ TEST_CASE_METHOD(string_var_fixture, "User-defined parser and validator lambda",
 	}
 }
 
+TEST_CASE("Delimited container variables", "[libenvpp]")
+{
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	const auto cpus_id = pre.register_variable<std::vector<int>>("CPUS");
+	const auto seeds_id = pre.register_required_variable<std::vector<std::pair<std::string, int>>>("SEEDS");
+	using hosts_t = std::set<std::string>;
+	const auto hosts_id = pre.register_variable<hosts_t>("HOSTS", delimited_parser_and_validator<hosts_t>(' '));
+	const auto labels_id = pre.register_variable<flat_map<std::string, std::string>>("LABELS");
+
+	SECTION("Valid lists")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate({
+		    {"LIBENVPP_TESTING_CPUS", "0,2,4,6"},
+		    {"LIBENVPP_TESTING_SEEDS", "a:1,b:2,c:3"},
+		    {"LIBENVPP_TESTING_HOSTS", "b a"},
+		    {"LIBENVPP_TESTING_LABELS", "zone=a,tier=hot"},
+		});
+		REQUIRE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(labels_id)
+		      == flat_map<std::string, std::string>{{"tier", "hot"}, {"zone", "a"}});
+		CHECK(parsed_and_validated_pre.get(cpus_id) == std::vector<int>{0, 2, 4, 6});
+		CHECK(parsed_and_validated_pre.get(seeds_id)
+		      == std::vector<std::pair<std::string, int>>{{"a", 1}, {"b", 2}, {"c", 3}});
+		CHECK(parsed_and_validated_pre.get(hosts_id) == std::set<std::string>{"a", "b"});
+	}
+
+	SECTION("Invalid elements")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate({
+		    {"LIBENVPP_TESTING_CPUS", "0,2,four"},
+		    {"LIBENVPP_TESTING_SEEDS", "a:1,b"},
+		    {"LIBENVPP_TESTING_HOSTS", "a b a"},
+		    {"LIBENVPP_TESTING_LABELS", "zone=a,zone=b"},
+		});
+		REQUIRE(parsed_and_validated_pre.errors().size() == 4);
+		CHECK_THAT(parsed_and_validated_pre.error_message(), ContainsSubstring("Duplicate key 'zone'"));
+		CHECK_THAT(parsed_and_validated_pre.error_message(), ContainsSubstring("Element 2 'a': Duplicate element"));
+		CHECK_THAT(parsed_and_validated_pre.error_message(),
+		           ContainsSubstring("Parser error for environment variable 'LIBENVPP_TESTING_CPUS': Element 2 'four'")
+		               && ContainsSubstring("'LIBENVPP_TESTING_SEEDS': Element 1 'b'"));
+	}
+}
+
+TEST_CASE("Binary data variables", "[libenvpp]")
+{
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	const auto key_id = pre.register_required_variable<env::bytes>("KEY");
+	const auto salt_id = pre.register_variable<env::bytes>("SALT", bytes_parser_and_validator(bytes_encoding::hex));
+
+	SECTION("Valid encodings")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate({
+		    {"LIBENVPP_TESTING_KEY", "AAEC/w=="},
+		    {"LIBENVPP_TESTING_SALT", "00ff10"},
+		});
+		REQUIRE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(key_id)
+		      == env::bytes{std::byte{0x00}, std::byte{0x01}, std::byte{0x02}, std::byte{0xFF}});
+		CHECK(parsed_and_validated_pre.get(salt_id) == env::bytes{std::byte{0x00}, std::byte{0xFF}, std::byte{0x10}});
+	}
+
+	SECTION("Invalid encodings")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate({
+		    {"LIBENVPP_TESTING_KEY", "AAEC/w="},
+		    {"LIBENVPP_TESTING_SALT", "00fg"},
+		});
+		REQUIRE(parsed_and_validated_pre.errors().size() == 2);
+		CHECK_THAT(parsed_and_validated_pre.error_message(),
+		           ContainsSubstring("'LIBENVPP_TESTING_KEY': Invalid base64 input 'AAEC/w='")
+		               && ContainsSubstring("'LIBENVPP_TESTING_SALT': Invalid hex character 'g' at position 3"));
+	}
+}
+
+TEST_CASE_METHOD(int_var_fixture, "Move-only types", "[libenvpp]")
+{
+	const auto unique_int_parser_and_validator = [](const std::string_view str) {
+		return std::make_unique<int>(default_parser_and_validator<int>{}(str));
+	};
+
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	const auto optional_id = pre.register_variable<std::unique_ptr<int>>("INT", unique_int_parser_and_validator);
+	const auto required_id =
+	    pre.register_required_variable<std::unique_ptr<int>>("INT_REQUIRED", unique_int_parser_and_validator);
+	const auto unset_id = pre.register_variable<std::unique_ptr<int>>("UNSET", unique_int_parser_and_validator);
+	pre.set_for_testing(required_id, std::make_unique<int>(7));
+	auto parsed_and_validated_pre = pre.parse_and_validate();
+	REQUIRE(parsed_and_validated_pre.ok());
+
+	REQUIRE(parsed_and_validated_pre.get_ref(optional_id).has_value());
+	CHECK(*parsed_and_validated_pre.get_ref(optional_id)->get() == 42);
+	CHECK(*parsed_and_validated_pre.get_ref(required_id) == 7);
+
+	const auto* const required_ptr = parsed_and_validated_pre.get_ref(required_id).get();
+	const auto required_val = std::move(parsed_and_validated_pre).take(required_id);
+	CHECK(required_val.get() == required_ptr);
+	CHECK_THROWS_AS(parsed_and_validated_pre.get_ref(required_id), value_error);
+	CHECK_THROWS_AS(std::move(parsed_and_validated_pre).take(required_id), value_error);
+
+	const auto optional_val = std::move(parsed_and_validated_pre).take(optional_id);
+	REQUIRE(optional_val.has_value());
+	CHECK(**optional_val == 42);
+	CHECK_FALSE(parsed_and_validated_pre.get_ref(optional_id).has_value());
+	CHECK_FALSE(std::move(parsed_and_validated_pre).take(optional_id).has_value());
+
+	CHECK_FALSE(std::move(parsed_and_validated_pre).take(unset_id).has_value());
+}
+
+TEST_CASE("Borrowed string types outlive the environment", "[libenvpp]")
+{
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	const auto view_id = pre.register_required_variable<std::string_view>("VIEW");
+	const auto option_id = pre.register_option<std::string_view>("OPTION", {"foo", "bar"});
+
+	const auto check_prefix = [&](const auto& parsed_pre) {
+		CHECK(parsed_pre.ok());
+		CHECK(parsed_pre.get(view_id) == "Hello World");
+		CHECK(parsed_pre.get_or(option_id, "foo") == "bar");
+	};
+
+	SECTION("System environment")
+	{
+		auto parsed_and_validated_pre = [&] {
+			const auto _ = detail::set_scoped_environment_variable{"LIBENVPP_TESTING_VIEW", "Hello World"};
+			const auto __ = detail::set_scoped_environment_variable{"LIBENVPP_TESTING_OPTION", "bar"};
+			return pre.parse_and_validate();
+		}();
+		check_prefix(parsed_and_validated_pre);
+	}
+
+	SECTION("Testing environment")
+	{
+		auto parsed_and_validated_pre = [&] {
+			const auto _ = scoped_test_environment{
+			    std::unordered_map<std::string, std::string>{{"LIBENVPP_TESTING_VIEW", "Hello World"},
+			                                                 {"LIBENVPP_TESTING_OPTION", "bar"}}};
+			return pre.parse_and_validate();
+		}();
+		check_prefix(parsed_and_validated_pre);
+	}
+
+	SECTION("Custom environment")
+	{
+		auto parsed_and_validated_pre = pre.parse_and_validate(std::unordered_map<std::string, std::string>{
+		    {"LIBENVPP_TESTING_VIEW", "Hello World"}, {"LIBENVPP_TESTING_OPTION", "bar"}});
+		check_prefix(parsed_and_validated_pre);
+	}
+}
+
 TEST_CASE("Unset environment variables", "[libenvpp]")
 {
 	constexpr auto prefix_name = "LIBENVPP_TESTING";
@@ -381,6 +646,27 @@ TEST_CASE_METHOD(int_var_fixture, "Typos in prefix are detected", "[libenvpp]")
 	               && ContainsSubstring("did you mean 'LIBVENPP_TESTING_INT'"));
 }
 
+TEST_CASE_METHOD(int_var_fixture, "Typos in prefix are detected in every environment", "[libenvpp]")
+{
+	const auto use_process_snapshot = GENERATE(false, true);
+	if (use_process_snapshot) {
+		[[maybe_unused]] const auto snapshot = detail::get_environment_snapshot();
+	} else {
+		env::refresh_snapshot();
+	}
+
+	auto pre = env::prefix("LIBVENPP_TESTING");
+	[[maybe_unused]] const auto int_id = pre.register_required_variable<std::string_view>("INT");
+	const auto set_id = pre.register_variable<std::string_view>("SET");
+	pre.set_for_testing(set_id, "set");
+	const auto parsed_and_validated_pre = pre.parse_and_validate();
+
+	CHECK(parsed_and_validated_pre.get(set_id) == "set");
+	CHECK_THAT(parsed_and_validated_pre.error_message(),
+	           ContainsSubstring("'LIBENVPP_TESTING_INT' set")
+	               && ContainsSubstring("did you mean 'LIBVENPP_TESTING_INT'"));
+}
+
 TEST_CASE("Typo detection does not trigger on already consumed variables", "[libenvpp]")
 {
 	const auto foo_var = detail::set_scoped_environment_variable{"LIBENVPP_TESTING_FOO", "BAR"};
@@ -551,6 +837,128 @@ TEST_CASE("Set for testing", "[libenvpp]")
 	CHECK(float_val == 3.1415f);
 }
 
+TEST_CASE("Default values", "[libenvpp]")
+{
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	const auto int_id = pre.register_variable<int>("INT", 7);
+	const auto string_id = pre.register_variable<std::string>("STRING", "default");
+	const auto doubled_id = pre.register_variable<int>(
+	    "DOUBLED", 3, [](const std::string_view str) { return 2 * std::stoi(std::string(str)); });
+	const auto option_id = pre.register_variable<testing_option>("OPTION", testing_option::FIRST_OPTION);
+	static_assert(std::is_same_v<decltype(pre.register_variable<int>("UNUSED", 0)), variable_id<int, true>>);
+
+	SECTION("Unset variables resolve to their default value")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate({});
+		CHECK(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(int_id) == 7);
+		CHECK_THAT(parsed_and_validated_pre.get(string_id), Equals("default"));
+		CHECK(parsed_and_validated_pre.get(doubled_id) == 3);
+		CHECK(parsed_and_validated_pre.get(option_id) == testing_option::FIRST_OPTION);
+	}
+
+	SECTION("Set variables are parsed")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate({
+		    {"LIBENVPP_TESTING_INT", "42"},
+		    {"LIBENVPP_TESTING_STRING", "set"},
+		    {"LIBENVPP_TESTING_DOUBLED", "21"},
+		    {"LIBENVPP_TESTING_OPTION", "SECOND_OPTION"},
+		});
+		CHECK(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(int_id) == 42);
+		CHECK_THAT(parsed_and_validated_pre.get(string_id), Equals("set"));
+		CHECK(parsed_and_validated_pre.get(doubled_id) == 42);
+		CHECK(parsed_and_validated_pre.get(option_id) == testing_option::SECOND_OPTION);
+	}
+
+	SECTION("Errors and typos resolve to the default value")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate({
+		    {"LIBENVPP_TESTING_INT", "forty-two"},
+		    {"LIBENVPP_TESTING_STRIN", "typo"},
+		});
+		REQUIRE(parsed_and_validated_pre.errors().size() == 1);
+		CHECK_THAT(parsed_and_validated_pre.error_message(), ContainsSubstring("'LIBENVPP_TESTING_INT'"));
+		REQUIRE(parsed_and_validated_pre.warnings().size() == 1);
+		CHECK_THAT(parsed_and_validated_pre.warning_message(), ContainsSubstring("'LIBENVPP_TESTING_STRIN' set"));
+		CHECK(parsed_and_validated_pre.get(int_id) == 7);
+		CHECK_THAT(parsed_and_validated_pre.get(string_id), Equals("default"));
+	}
+
+	SECTION("Default values are listed in the help message")
+	{
+		CHECK_THAT(pre.help_message(), ContainsSubstring("'LIBENVPP_TESTING_INT' optional (default: 7)")
+		                                   && ContainsSubstring("'LIBENVPP_TESTING_STRING' optional (default: default)")
+		                                   && ContainsSubstring("'LIBENVPP_TESTING_OPTION' optional\n"));
+	}
+}
+
+TEST_CASE("Binding variables to struct members", "[libenvpp]")
+{
+	struct config {
+		int num_threads = 1;
+		std::string log_path = "default.log";
+		float ratio = 0.5f;
+	};
+
+	auto cfg = config{};
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	pre.bind_required("NUM_THREADS", cfg, &config::num_threads);
+	pre.bind("LOG_PATH", cfg, &config::log_path);
+	pre.bind("RATIO", cfg, &config::ratio, [](const std::string_view str) { return 2 * std::stof(std::string(str)); });
+
+	SECTION("Set variables are parsed into the struct")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate({
+		    {"LIBENVPP_TESTING_NUM_THREADS", "8"},
+		    {"LIBENVPP_TESTING_LOG_PATH", "/var/log/app.log"},
+		    {"LIBENVPP_TESTING_RATIO", "1.5"},
+		});
+		CHECK(parsed_and_validated_pre.ok());
+		CHECK(cfg.num_threads == 8);
+		CHECK_THAT(cfg.log_path, Equals("/var/log/app.log"));
+		CHECK(cfg.ratio == 3.0f);
+	}
+
+	SECTION("Unset and invalid variables keep their value")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate({
+		    {"LIBENVPP_TESTING_NUM_THREADS", "eight"},
+		    {"LIBENVPP_TESTING_LOG_PAHT", "/var/log/app.log"},
+		});
+		CHECK(cfg.num_threads == 1);
+		CHECK_THAT(cfg.log_path, Equals("default.log"));
+		REQUIRE(parsed_and_validated_pre.errors().size() == 1);
+		CHECK(parsed_and_validated_pre.errors()[0].get_id() == 0);
+		CHECK_THAT(parsed_and_validated_pre.error_message(),
+		           ContainsSubstring("Parser error") && ContainsSubstring("'LIBENVPP_TESTING_NUM_THREADS'"));
+		REQUIRE(parsed_and_validated_pre.warnings().size() == 1);
+		CHECK_THAT(parsed_and_validated_pre.warning_message(),
+		           ContainsSubstring("'LIBENVPP_TESTING_LOG_PAHT' set")
+		               && ContainsSubstring("did you mean 'LIBENVPP_TESTING_LOG_PATH'"));
+	}
+
+	SECTION("Errors and warnings match registered variables")
+	{
+		auto registered_pre = env::prefix("LIBENVPP_TESTING");
+		[[maybe_unused]] const auto num_threads_id = registered_pre.register_required_variable<int>("NUM_THREADS");
+		[[maybe_unused]] const auto log_path_id = registered_pre.register_variable<std::string>("LOG_PATH");
+		[[maybe_unused]] const auto ratio_id = registered_pre.register_variable<float>("RATIO");
+		CHECK_THAT(pre.help_message(), Equals(registered_pre.help_message()));
+
+		const auto environment = std::unordered_map<std::string, std::string>{
+		    {"LIBENVPP_TESTING_NUM_THREAD", "8"},
+		    {"LIBENVPP_TESTING_LOG_PATH", "/var/log/app.log"},
+		    {"LIBENVPP_TESTING_UNUSED", "1"},
+		};
+		const auto parsed_bound = pre.parse_and_validate(environment);
+		const auto parsed_registered = registered_pre.parse_and_validate(environment);
+		CHECK_THAT(parsed_bound.error_message(), Equals(parsed_registered.error_message()));
+		CHECK_THAT(parsed_bound.warning_message(), Equals(parsed_registered.warning_message()));
+	}
+}
+
 TEST_CASE("Help message", "[libenvpp]")
 {
 	auto pre = env::prefix("LIBENVPP_TESTING");
@@ -702,6 +1110,37 @@ TEST_CASE_METHOD(int_var_fixture, "Range environment variables", "[libenvpp]")
 	}
 }
 
+TEST_CASE("Range of durations and byte sizes", "[libenvpp]")
+{
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	const auto timeout_id =
+	    pre.register_range<std::chrono::milliseconds>("TIMEOUT", std::chrono::seconds{1}, std::chrono::minutes{1});
+	const auto cache_id = pre.register_required_range<byte_size>("CACHE", mebibytes(1), gibibytes(1));
+
+	SECTION("Within range")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate({
+		    {"LIBENVPP_TESTING_TIMEOUT", "1m"},
+		    {"LIBENVPP_TESTING_CACHE", "512MiB"},
+		});
+		REQUIRE(parsed_and_validated_pre.ok());
+		CHECK(parsed_and_validated_pre.get(timeout_id) == std::chrono::minutes{1});
+		CHECK(parsed_and_validated_pre.get(cache_id) == mebibytes(512));
+	}
+
+	SECTION("Outside of range")
+	{
+		const auto parsed_and_validated_pre = pre.parse_and_validate({
+		    {"LIBENVPP_TESTING_TIMEOUT", "250ms"},
+		    {"LIBENVPP_TESTING_CACHE", "2GiB"},
+		});
+		REQUIRE(parsed_and_validated_pre.errors().size() == 2);
+		CHECK_THAT(parsed_and_validated_pre.error_message(),
+		           ContainsSubstring("Value 250ms outside of range [1000ms, 60000ms]")
+		               && ContainsSubstring("Value 2147483648B outside of range [1048576B, 1073741824B]"));
+	}
+}
+
 TEST_CASE("Invalid range registered", "[libenvpp]")
 {
 	auto pre = env::prefix("LIBENVPP_TESTING");
@@ -956,6 +1395,126 @@ TEST_CASE("Custom environment", "[libenvpp]")
 	}
 }
 
+struct sorted_environment {
+	std::vector<std::pair<std::string, std::string>> vars;
+};
+
+template <>
+struct environment_source<sorted_environment> {
+	[[nodiscard]] std::optional<std::string_view> find(const sorted_environment& environment,
+	                                                   const std::string_view name) const
+	{
+		const auto it = std::lower_bound(environment.vars.begin(), environment.vars.end(), name,
+		                                 [](const auto& var, const std::string_view key) { return var.first < key; });
+		if (it == environment.vars.end() || it->first != name) {
+			return std::nullopt;
+		}
+		return it->second;
+	}
+
+	template <typename Fn>
+	void for_each(const sorted_environment& environment, Fn&& fn) const
+	{
+		for (const auto& [name, value] : environment.vars) {
+			fn(name, value);
+		}
+	}
+};
+
+TEST_CASE("Custom environment sources", "[libenvpp]")
+{
+	const auto check_environment = [](const auto& custom_env) {
+		auto pre = env::prefix("LIBENVPP_TESTING");
+		const auto int_id = pre.register_required_variable<int>("INT");
+		const auto float_id = pre.register_variable<float>("FLOAT");
+		[[maybe_unused]] const auto string_id = pre.register_variable<std::string>("STRING");
+
+		auto parsed_and_validated_pre = pre.parse_and_validate(custom_env);
+		CHECK(parsed_and_validated_pre.get(int_id) == 42);
+		CHECK(parsed_and_validated_pre.get(float_id) == 3.1415f);
+		CHECK(parsed_and_validated_pre.errors().empty());
+		REQUIRE(parsed_and_validated_pre.warnings().size() == 2);
+		CHECK_THAT(parsed_and_validated_pre.warnings()[0].what(),
+		           ContainsSubstring("'LIBENVPP_TESTING_STRNG' set, did you mean 'LIBENVPP_TESTING_STRING'"));
+		CHECK_THAT(parsed_and_validated_pre.warnings()[1].what(),
+		           ContainsSubstring("'LIBENVPP_TESTING_UNUSED' specified but unused"));
+	};
+
+	SECTION("Vector of pairs")
+	{
+		const auto custom_env = std::vector<std::pair<std::string_view, std::string_view>>{
+		    {"LIBENVPP_TESTING_INT", "42"},
+		    {"LIBENVPP_TESTING_FLOAT", "3.1415"},
+		    {"LIBENVPP_TESTING_STRNG", "Hello World"},
+		    {"LIBENVPP_TESTING_UNUSED", "unused"},
+		};
+		check_environment(custom_env);
+	}
+
+	SECTION("Transparent map")
+	{
+		const auto custom_env = std::map<std::string, std::string, std::less<>>{
+		    {"LIBENVPP_TESTING_INT", "42"},
+		    {"LIBENVPP_TESTING_FLOAT", "3.1415"},
+		    {"LIBENVPP_TESTING_STRNG", "Hello World"},
+		    {"LIBENVPP_TESTING_UNUSED", "unused"},
+		};
+		check_environment(custom_env);
+	}
+
+	SECTION("Specialized environment source")
+	{
+		const auto custom_env = sorted_environment{{
+		    {"LIBENVPP_TESTING_FLOAT", "3.1415"},
+		    {"LIBENVPP_TESTING_INT", "42"},
+		    {"LIBENVPP_TESTING_STRNG", "Hello World"},
+		    {"LIBENVPP_TESTING_UNUSED", "unused"},
+		}};
+		check_environment(custom_env);
+	}
+}
+
+TEST_CASE("Custom environment is not modified", "[libenvpp]")
+{
+	const auto custom_env = std::unordered_map<std::string, std::string>{
+	    {"LIBENVPP_TESTING_INT", "42"},
+	    {"LIBENVPP_TESTING_UNUSED", "unused"},
+	};
+
+	for (auto i = 0; i < 2; ++i) {
+		auto pre = env::prefix("LIBENVPP_TESTING");
+		const auto int_id = pre.register_variable<int>("INT");
+		auto parsed_and_validated_pre = pre.parse_and_validate(custom_env);
+		CHECK(parsed_and_validated_pre.get(int_id) == 42);
+		CHECK(parsed_and_validated_pre.warnings().size() == 1);
+	}
+	CHECK(custom_env.size() == 2);
+}
+
+TEST_CASE("Custom environment view", "[libenvpp]")
+{
+	constexpr const char* custom_vars[] = {
+	    "LIBENVPP_TESTING_INT=42",
+	    "LIBENVPP_TESTING_FLAOT=3.1415",
+	    "LIBENVPP_TESTING_UNUSED=unused",
+	    nullptr,
+	};
+	const auto custom_env = detail::environment_view(custom_vars);
+
+	auto pre = env::prefix("LIBENVPP_TESTING");
+	const auto int_id = pre.register_required_variable<int>("INT");
+	[[maybe_unused]] const auto float_id = pre.register_variable<float>("FLOAT");
+
+	auto parsed_and_validated_pre = pre.parse_and_validate(custom_env);
+	CHECK(parsed_and_validated_pre.get(int_id) == 42);
+	CHECK(parsed_and_validated_pre.errors().empty());
+	REQUIRE(parsed_and_validated_pre.warnings().size() == 2);
+	CHECK_THAT(parsed_and_validated_pre.warnings()[0].what(),
+	           ContainsSubstring("'LIBENVPP_TESTING_FLAOT' set, did you mean 'LIBENVPP_TESTING_FLOAT'"));
+	CHECK_THAT(parsed_and_validated_pre.warnings()[1].what(),
+	           ContainsSubstring("'LIBENVPP_TESTING_UNUSED' specified but unused"));
+}
+
 TEST_CASE_METHOD(int_var_fixture, "Variable IDs can only be copied", "[libenvpp]")
 {
 	constexpr auto prefix_name = "LIBENVPP_TESTING";
@@ -1077,6 +1636,7 @@ TEST_CASE("Parsed and validated prefix can be moved", "[libenvpp]")
 		CHECK_THAT(parsed_pre.help_message(), ContainsSubstring("'LIBENVPP_TESTING_ENV_VAR' optional"));
 		CHECK(parsed_pre.get_or(int_var, 4) == 7);
 		CHECK(*parsed_pre.get(int_var) == 7);
+		CHECK(parsed_pre.get_ref(int_var)->get() == 7);
 	};
 
 	SECTION("Move construction")
@@ -1109,6 +1669,7 @@ TEST_CASE("Moved from parsed and validated prefix throws", "[libenvpp]")
 		CHECK_THROWS_AS(parsed_pre.help_message(), invalidated_prefix);
 		CHECK_THROWS_AS(parsed_pre.get_or(int_var, 4), invalidated_prefix);
 		CHECK_THROWS_AS(parsed_pre.get(int_var), invalidated_prefix);
+		CHECK_THROWS_AS(parsed_pre.get_ref(int_var), invalidated_prefix);
 	};
 
 	SECTION("Move construction")
@@ -1189,6 +1750,38 @@ TEST_CASE_METHOD(int_var_fixture, "Typo detection when using get", "[libenvpp][g
 	CHECK_THAT(value.error().get_name(), Equals("LIBENVPP_TESTING_HINT"));
 }
 
+TEST_CASE("Retrieving multiple variables with get_many", "[libenvpp][get]")
+{
+	const auto _int = detail::set_scoped_environment_variable{"LIBENVPP_TESTING_INT", "42"};
+	const auto _string = detail::set_scoped_environment_variable{"LIBENVPP_TESTING_STRING", "Hello World"};
+	const auto _float = detail::set_scoped_environment_variable{"LIBENVPP_TESTING_FLOAT", "FOO"};
+	const auto _test = scoped_test_environment{"LIBENVPP_TESTING_OVERLAY", "7"};
+
+	const auto [int_value, string_value, float_value, overlay_value, missing_value, similar_value] =
+	    get_many<int, std::string, float, unsigned, int, std::string>(
+	        "LIBENVPP_TESTING_INT", "LIBENVPP_TESTING_STRING", "LIBENVPP_TESTING_FLOAT", "LIBENVPP_TESTING_OVERLAY",
+	        "LIBENVPP_TESTING_NOT_SET_AT_ALL", "LIBENVPP_TESTING_STRONG");
+
+	REQUIRE(int_value.has_value());
+	CHECK(*int_value == 42);
+	REQUIRE(string_value.has_value());
+	CHECK(*string_value == "Hello World");
+	REQUIRE(overlay_value.has_value());
+	CHECK(*overlay_value == 7);
+
+	REQUIRE_FALSE(float_value.has_value());
+	CHECK_THAT(float_value.error().what(),
+	           ContainsSubstring("Parser error") && ContainsSubstring("'LIBENVPP_TESTING_FLOAT'"));
+
+	REQUIRE_FALSE(missing_value.has_value());
+	CHECK_THAT(missing_value.error().what(), ContainsSubstring("'LIBENVPP_TESTING_NOT_SET_AT_ALL' not set"));
+
+	REQUIRE_FALSE(similar_value.has_value());
+	CHECK_THAT(similar_value.error().what(), ContainsSubstring("'LIBENVPP_TESTING_STRING' set")
+	                                             && ContainsSubstring("did you mean 'LIBENVPP_TESTING_STRONG'"));
+	CHECK_THAT(similar_value.error().get_name(), Equals("LIBENVPP_TESTING_STRONG"));
+}
+
 TEST_CASE("Retrieving integer with get_or", "[libenvpp][get]")
 {
 	SECTION("Set environment variable")
@@ -1240,4 +1833,98 @@ TEST_CASE("Deprecated environment variables work as expected", "[libenvpp][depre
 	}
 }
 
+struct schema_config {
+	int num_threads = 1;
+	std::string log_path = "/default/log/path";
+	std::optional<unsigned> port;
+	testing_option mode = testing_option::FIRST_OPTION;
+};
+
+constexpr auto config_schema = env::schema(
+    "LIBENVPP_TESTING", env::schema_variable<&schema_config::num_threads, env::required>("NUM_THREADS"),
+    env::schema_variable<&schema_config::log_path>("LOG_PATH"),
+    env::schema_variable<&schema_config::port, env::range<1, 65535>>("PORT"),
+    env::schema_variable<&schema_config::mode,
+                         env::options<testing_option::SECOND_OPTION, testing_option::THIRD_OPTION>>("MODE"));
+
+TEST_CASE("Compile-time schema", "[libenvpp][schema]")
+{
+	SECTION("All variables set")
+	{
+		const auto parsed = config_schema.parse_and_validate(std::unordered_map<std::string, std::string>{
+		    {"LIBENVPP_TESTING_NUM_THREADS", "8"},
+		    {"LIBENVPP_TESTING_LOG_PATH", "/var/log"},
+		    {"LIBENVPP_TESTING_PORT", "8080"},
+		    {"LIBENVPP_TESTING_MODE", "THIRD_OPTION"}});
+		CHECK(parsed.ok());
+		const auto& config = parsed.values();
+		CHECK(config.num_threads == 8);
+		CHECK(config.log_path == "/var/log");
+		CHECK(config.port == 8080u);
+		CHECK(config.mode == testing_option::THIRD_OPTION);
+	}
+
+	SECTION("Defaults")
+	{
+		const auto parsed = config_schema.parse_and_validate(
+		    std::unordered_map<std::string, std::string>{{"LIBENVPP_TESTING_NUM_THREADS", "8"}});
+		CHECK(parsed.ok());
+		const auto config = std::move(parsed).values();
+		CHECK(config.num_threads == 8);
+		CHECK(config.log_path == "/default/log/path");
+		CHECK_FALSE(config.port.has_value());
+		CHECK(config.mode == testing_option::FIRST_OPTION);
+	}
+
+	SECTION("Same errors and warnings as prefix")
+	{
+		const auto environment = std::unordered_map<std::string, std::string>{
+		    {"LIBENVPP_TESTING_NUM_THREAD", "8"},
+		    {"LIBENVPP_TESTING_LOG_PAHT", "/var/log"},
+		    {"LIBENVPP_TESTING_PORT", "0"},
+		    {"LIBENVPP_TESTING_MODE", "FIRST_OPTION"},
+		    {"LIBENVPP_TESTING_UNUSED", "foo"}};
+
+		auto pre = env::prefix("LIBENVPP_TESTING");
+		(void)pre.register_required_variable<int>("NUM_THREADS");
+		(void)pre.register_variable<std::string>("LOG_PATH");
+		(void)pre.register_range<unsigned>("PORT", 1, 65535);
+		(void)pre.register_option<testing_option>("MODE",
+		                                          {testing_option::SECOND_OPTION, testing_option::THIRD_OPTION});
+		const auto parsed_pre = pre.parse_and_validate(environment);
+		const auto parsed_schema = config_schema.parse_and_validate(environment);
+
+		CHECK_FALSE(parsed_schema.ok());
+		CHECK(parsed_schema.errors().size() == 3);
+		CHECK(parsed_schema.warnings().size() == 2);
+		CHECK(parsed_schema.error_message() == parsed_pre.error_message());
+		CHECK(parsed_schema.warning_message() == parsed_pre.warning_message());
+		for (std::size_t i = 0; i < parsed_pre.errors().size(); ++i) {
+			CHECK(parsed_schema.errors()[i].get_id() == parsed_pre.errors()[i].get_id());
+			CHECK(parsed_schema.errors()[i].get_name() == parsed_pre.errors()[i].get_name());
+		}
+		CHECK(config_schema.help_message() == parsed_pre.help_message());
+	}
+
+	SECTION("Testing environment")
+	{
+		const auto _ = scoped_test_environment{"LIBENVPP_TESTING_NUM_THREADS", "4"};
+		const auto parsed = config_schema.parse_and_validate();
+		CHECK(parsed.ok());
+		CHECK(parsed.values().num_threads == 4);
+	}
+
+	SECTION("Invalid schema")
+	{
+		using num_threads_t = env::schema_variable<&schema_config::num_threads>;
+		using log_path_t = env::schema_variable<&schema_config::log_path>;
+		CHECK_THROWS_AS(env::schema("", num_threads_t("NUM_THREADS")), invalid_prefix);
+		CHECK_THROWS_AS(env::schema("LIBENVPP=TESTING", num_threads_t("NUM_THREADS")), invalid_prefix);
+		CHECK_THROWS_AS(env::schema("LIBENVPP_TESTING", num_threads_t("")), invalid_variable_name);
+		CHECK_THROWS_AS(env::schema("LIBENVPP_TESTING", num_threads_t("NUM=THREADS")), invalid_variable_name);
+		CHECK_THROWS_AS(env::schema("LIBENVPP_TESTING", num_threads_t("NAME"), log_path_t("NAME")),
+		                duplicate_variable);
+	}
+}
+
 } // namespace env